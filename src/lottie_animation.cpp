@@ -1,4 +1,11 @@
 #include "lottie_animation.h"
+#include "lottie_pixel_utils.h"
+#include "lottie_buffer_pool.h"
+#include "lottie_resident_pool.h"
+#include "lottie_resolution_manager.h"
+#include "lottie_render_scheduler.h"
+#include "lottie_preloader.h"
+#include "lottie_disk_cache.h"
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <godot_cpp/classes/rendering_server.hpp>
@@ -10,105 +17,31 @@
 #include <godot_cpp/classes/node2d.hpp>
 #include <godot_cpp/classes/viewport.hpp>
 #include <godot_cpp/classes/camera2d.hpp>
+#include <godot_cpp/classes/shader.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
 #include <algorithm>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
 #include <vector>
+#include <unordered_map>
 
 #include <thorvg.h>
 
 using namespace godot;
 
-#if defined(__SSSE3__)
-    #include <tmmintrin.h>
-    #define LOTTIE_SIMD_SSSE3 1
-#endif
-#if defined(__ARM_NEON)
-    #include <arm_neon.h>
-    #define LOTTIE_SIMD_NEON 1
-#endif
-
-static inline void _convert_argb_to_rgba_optimized(const uint32_t *src, uint8_t *dst, size_t count) {
-#if LOTTIE_SIMD_SSSE3
-    size_t vec_count = count / 4;
-    const __m128i mask = _mm_setr_epi8(
-        2, 1, 0, 3,
-        6, 5, 4, 7,
-        10, 9, 8, 11,
-        14, 13, 12, 15
-    );
-    const __m128i *srcv = reinterpret_cast<const __m128i*>(src);
-    __m128i *dstv = reinterpret_cast<__m128i*>(dst);
-    for (size_t i = 0; i < vec_count; ++i) {
-        __m128i pixels = _mm_loadu_si128(&srcv[i]);
-        __m128i shuffled = _mm_shuffle_epi8(pixels, mask);
-        _mm_storeu_si128(&dstv[i], shuffled);
-    }
-    size_t processed = vec_count * 4;
-    for (size_t i = processed; i < count; ++i) {
-        uint32_t p = src[i];
-        dst[i*4 + 0] = (uint8_t)((p >> 16) & 0xFF);
-        dst[i*4 + 1] = (uint8_t)((p >> 8) & 0xFF);
-        dst[i*4 + 2] = (uint8_t)(p & 0xFF);
-        dst[i*4 + 3] = (uint8_t)((p >> 24) & 0xFF);
-    }
-#elif LOTTIE_SIMD_NEON
-    size_t vec_count = count / 4;
-    static const uint8_t tbl_data[16] = {
-        2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15
-    };
-    uint8x16_t tbl = vld1q_u8(tbl_data);
-    for (size_t i = 0; i < vec_count; ++i) {
-        uint8x16_t pixels = vld1q_u8(reinterpret_cast<const uint8_t*>(&src[i*4]));
-#if defined(__aarch64__) || defined(__ARM_FEATURE_QBIT)
-        uint8x16_t shuffled = vqtbl1q_u8(pixels, tbl);
-#else
-        uint8_t tmp[16];
-        vst1q_u8(tmp, pixels);
-        uint8_t out[16];
-        for (int k=0;k<16;k++) out[k] = tmp[tbl_data[k]];
-        pixels = vld1q_u8(out);
-        uint8x16_t shuffled = pixels;
-#endif
-        vst1q_u8(&dst[i*16], shuffled);
-    }
-    size_t processed = vec_count * 4;
-    for (size_t i = processed; i < count; ++i) {
-        uint32_t p = src[i];
-        dst[i*4 + 0] = (uint8_t)((p >> 16) & 0xFF);
-        dst[i*4 + 1] = (uint8_t)((p >> 8) & 0xFF);
-        dst[i*4 + 2] = (uint8_t)(p & 0xFF);
-        dst[i*4 + 3] = (uint8_t)((p >> 24) & 0xFF);
-    }
-#else
-    for (size_t i = 0; i < count; ++i) {
-        uint32_t p = src[i];
-        dst[i*4 + 0] = (uint8_t)((p >> 16) & 0xFF);
-        dst[i*4 + 1] = (uint8_t)((p >> 8) & 0xFF);
-        dst[i*4 + 2] = (uint8_t)(p & 0xFF);
-        dst[i*4 + 3] = (uint8_t)((p >> 24) & 0xFF);
-    }
-#endif
+void LottieAnimation::_fix_alpha_border_rgba(uint8_t *rgba, int w, int h) {
+    _fix_alpha_border_rgba_rect(rgba, w, h, 0, 0, w, h);
 }
 
-void LottieAnimation::_fix_alpha_border_rgba(uint8_t *rgba, int w, int h) {
+void LottieAnimation::_fix_alpha_border_rgba_rect(uint8_t *rgba, int w, int h, int x0, int y0, int x1, int y1) {
     if (!rgba || w <= 2 || h <= 2) return;
-    std::vector<uint8_t> rgb_copy((size_t)w * (size_t)h * 3);
-    for (int y = 0; y < h; ++y) {
-        const uint8_t *row = rgba + (size_t)y * (size_t)w * 4;
-        uint8_t *dst = rgb_copy.data() + (size_t)y * (size_t)w * 3;
-        for (int x = 0; x < w; ++x) {
-            dst[x*3+0] = row[x*4+0];
-            dst[x*3+1] = row[x*4+1];
-            dst[x*3+2] = row[x*4+2];
-        }
-    }
+    // Only transparent pixels are written and only opaque neighbours are read, so the pass
+    // can work in place and on any sub-rectangle.
     auto at = [&](int x, int y)->uint8_t* { return rgba + ((size_t)y * (size_t)w + (size_t)x) * 4; };
-    auto at_rgb = [&](int x, int y)->const uint8_t* { return rgb_copy.data() + ((size_t)y * (size_t)w + (size_t)x) * 3; };
-    for (int y = 1; y < h-1; ++y) {
-        for (int x = 1; x < w-1; ++x) {
+    for (int y = std::max(1, y0); y < std::min(h - 1, y1); ++y) {
+        for (int x = std::max(1, x0); x < std::min(w - 1, x1); ++x) {
             uint8_t *px = at(x,y);
             if (px[3] != 0) continue;
             bool copied = false;
@@ -117,10 +50,9 @@ void LottieAnimation::_fix_alpha_border_rgba(uint8_t *rgba, int w, int h) {
                     if (dx == 0 && dy == 0) continue;
                     uint8_t *n = at(x+dx, y+dy);
                     if (n[3] > 0) {
-                        const uint8_t *nrgb = at_rgb(x+dx, y+dy);
-                        px[0] = nrgb[0];
-                        px[1] = nrgb[1];
-                        px[2] = nrgb[2];
+                        px[0] = n[0];
+                        px[1] = n[1];
+                        px[2] = n[2];
                         copied = true;
                     }
                 }
@@ -129,6 +61,42 @@ void LottieAnimation::_fix_alpha_border_rgba(uint8_t *rgba, int w, int h) {
     }
 }
 
+void LottieAnimation::_convert_dirty_tiles(const uint32_t *argb, uint8_t *rgba, int w, int h, const LottieTileDiff &diff) {
+    if (diff.all_dirty()) {
+        lottie_convert_argb_to_rgba(argb, rgba, (size_t)w * (size_t)h);
+        if (unpremultiply_alpha) _unpremultiply_alpha_rgba(rgba, w, h);
+        if (fix_alpha_border) _fix_alpha_border_rgba(rgba, w, h);
+        return;
+    }
+    // Convert every dirty tile before fixing any, so fixes never read stale neighbours.
+    _convert_dirty_tile_rows(argb, rgba, w, h, diff, 0, 0, diff.tiles_y());
+    if (fix_alpha_border) _convert_dirty_tile_rows(argb, rgba, w, h, diff, 1, 0, diff.tiles_y());
+}
+
+void LottieAnimation::_convert_dirty_tile_rows(const uint32_t *argb, uint8_t *rgba, int w, int h, const LottieTileDiff &diff, int pass, int row0, int row1) {
+    // Tiles grow by one pixel: the alpha-border fix of a clean pixel can depend on a dirty neighbour.
+    const int T = LottieTileDiff::TILE_SIZE;
+    for (int ty = row0; ty < std::min(row1, diff.tiles_y()); ++ty) {
+        for (int tx = 0; tx < diff.tiles_x(); ++tx) {
+            if (!diff.is_dirty(tx, ty)) continue;
+            const int x0 = std::max(0, tx * T - 1);
+            const int y0 = std::max(0, ty * T - 1);
+            const int x1 = std::min(w, (tx + 1) * T + 1);
+            const int y1 = std::min(h, (ty + 1) * T + 1);
+            if (pass == 1) {
+                _fix_alpha_border_rgba_rect(rgba, w, h, x0, y0, x1, y1);
+                continue;
+            }
+            lottie_convert_argb_to_rgba_rect(argb, rgba, w, x0, y0, x1, y1);
+            if (unpremultiply_alpha) {
+                for (int y = y0; y < y1; ++y) {
+                    _unpremultiply_alpha_rgba(rgba + ((size_t)y * (size_t)w + (size_t)x0) * 4, x1 - x0, 1);
+                }
+            }
+        }
+    }
+}
+
 void LottieAnimation::_unpremultiply_alpha_rgba(uint8_t *rgba, int w, int h) {
     if (!rgba || w <= 0 || h <= 0) return;
     const size_t pixels = (size_t)w * (size_t)h;
@@ -163,29 +131,53 @@ static String _mirror_file_to_user_cache(const String &src_path) {
     fo->close();
     return mirror_rel;
 }
-static String _extract_lottie_json_to_cache(const String &zip_path, const String &preferred_entry = String()) {
+// Per-bundle data shared by every node using the same .lottie: the manifest is parsed and the
+// archive extracted once per file revision instead of on every animation switch.
+struct DotLottieBundle {
+    uint64_t modified_time = 0;
+    bool extracted = false;
+    bool manifest_parsed = false;
+    String cache_dir;
+    PackedStringArray files;
+    PackedStringArray animation_ids;
+    PackedStringArray machine_names;
+    Dictionary states_by_machine;
+    Dictionary anim_inner_paths;
+    Dictionary state_segments_by_machine;
+    Dictionary machine_sources;
+    std::vector<LottieResidentPool::Source> resident_sources; // extracted animation JSONs
+};
+static std::unordered_map<std::string, DotLottieBundle> g_dotlottie_bundles;
+
+static DotLottieBundle &_dotlottie_bundle(const String &zip_path) {
+    const uint64_t mtime = FileAccess::get_modified_time(zip_path);
+    DotLottieBundle &bundle = g_dotlottie_bundles[std::string(zip_path.utf8().get_data())];
+    if (bundle.modified_time != mtime) {
+        bundle = DotLottieBundle();
+        bundle.modified_time = mtime;
+    }
+    return bundle;
+}
+
+static bool _extract_lottie_bundle(const String &zip_path, DotLottieBundle &bundle) {
     Ref<ZIPReader> zr;
     zr.instantiate();
     if (zr.is_null()) {
         UtilityFunctions::printerr("Failed to open .lottie (zip): " + zip_path);
-        return String();
+        return false;
     }
 
-    String open_path = zip_path;
-    Error zerr = zr->open(open_path);
+    Error zerr = zr->open(zip_path);
     if (zerr != OK) {
         // On Web or when file is packed in PCK, mirror to user:// and try again.
         String mirrored = _mirror_file_to_user_cache(zip_path);
         if (!mirrored.is_empty()) {
             zerr = zr->open(mirrored);
-            if (zerr == OK) {
-                open_path = mirrored;
-            }
         }
     }
     if (zerr != OK) {
         UtilityFunctions::printerr("Failed to open .lottie (zip): " + zip_path);
-        return String();
+        return false;
     }
 
     PackedStringArray files = zr->get_files();
@@ -197,6 +189,51 @@ static String _extract_lottie_json_to_cache(const String &zip_path, const String
     String abs_cache_dir = ProjectSettings::get_singleton()->globalize_path(cache_dir);
     DirAccess::make_dir_recursive_absolute(abs_cache_dir);
 
+    // Extract all files to the cache folder, so relative assets resolve.
+    for (int i = 0; i < files.size(); i++) {
+        String entry = files[i];
+        if (entry.ends_with("/")) continue; // skip directory markers
+        // Ensure parent directory exists
+        String dest_rel = cache_dir.path_join(entry);
+        String dest_abs = ProjectSettings::get_singleton()->globalize_path(dest_rel);
+        String parent_abs = dest_abs.get_base_dir();
+        DirAccess::make_dir_recursive_absolute(parent_abs);
+        PackedByteArray data = zr->read_file(entry);
+        Ref<FileAccess> fo = FileAccess::open(dest_rel, FileAccess::WRITE);
+        if (fo.is_null()) {
+            // Try to create parent again just in case
+            DirAccess::make_dir_recursive_absolute(parent_abs);
+            fo = FileAccess::open(dest_rel, FileAccess::WRITE);
+        }
+        if (fo.is_valid()) {
+            fo->store_buffer(data);
+            fo->flush();
+            fo->close();
+        }
+        const String lower = entry.to_lower();
+        if (lower.ends_with(".json") && !lower.ends_with("manifest.json")) {
+            // The parsed scene graph scales with the JSON; a few times its size is a fair estimate.
+            LottieResidentPool::Source src;
+            src.path8 = dest_abs.utf8().get_data();
+            src.bytes = (size_t)data.size() * 4;
+            bundle.resident_sources.push_back(src);
+        }
+    }
+    zr->close();
+
+    bundle.files = files;
+    bundle.cache_dir = cache_dir;
+    bundle.extracted = true;
+    return true;
+}
+
+static String _extract_lottie_json_to_cache(const String &zip_path, const String &preferred_entry = String()) {
+    DotLottieBundle &bundle = _dotlottie_bundle(zip_path);
+    if (!bundle.extracted && !_extract_lottie_bundle(zip_path, bundle)) {
+        return String();
+    }
+    const PackedStringArray &files = bundle.files;
+
     String json_inside;
     auto file_exists_in_zip = [&](const String &p){ for (int i=0;i<files.size();++i){ if (files[i]==p) return true; } return false; };
     if (!preferred_entry.is_empty()) {
@@ -235,47 +272,14 @@ static String _extract_lottie_json_to_cache(const String &zip_path, const String
         }
     }
     if (json_inside.is_empty()) {
-        zr->close();
         UtilityFunctions::printerr(".lottie does not contain a JSON animation file");
         return String();
     }
 
-    // Extract all files to the cache folder, so relative assets resolve.
-    for (int i = 0; i < files.size(); i++) {
-        String entry = files[i];
-        if (entry.ends_with("/")) continue; // skip directory markers
-        // Ensure parent directory exists
-        String dest_rel = cache_dir.path_join(entry);
-        String dest_abs = ProjectSettings::get_singleton()->globalize_path(dest_rel);
-        String parent_abs = dest_abs.get_base_dir();
-        DirAccess::make_dir_recursive_absolute(parent_abs);
-        Ref<ZIPReader> zr3; zr3.instantiate();
-        if (zr3->open(open_path) != OK) {
-            UtilityFunctions::printerr("Failed to reopen .lottie for extract: " + open_path);
-            return String();
-        }
-        PackedByteArray data = zr3->read_file(entry);
-        zr3->close();
-        Ref<FileAccess> fo = FileAccess::open(dest_rel, FileAccess::WRITE);
-        if (fo.is_null()) {
-            // Try to create parent again just in case
-            DirAccess::make_dir_recursive_absolute(parent_abs);
-            fo = FileAccess::open(dest_rel, FileAccess::WRITE);
-        }
-        if (fo.is_valid()) {
-            fo->store_buffer(data);
-            fo->flush();
-            fo->close();
-        }
-    }
-    // zr already closed above.
-
     // Return the chosen JSON inside the extracted cache dir
-    String out_path = cache_dir.path_join(json_inside);
-    return out_path;
+    return bundle.cache_dir.path_join(json_inside);
 }
 
-#include <unordered_map>
 static std::unordered_map<std::string, int> g_anim_usage_counts;
 static inline void _registry_inc(const String &key) {
     if (key.is_empty()) return;
@@ -293,13 +297,73 @@ static inline int _registry_get(const String &key) {
     return it == g_anim_usage_counts.end() ? 0 : it->second;
 }
 
+struct LottieClockGroup {
+    double time = 0.0;
+    uint64_t advanced_frame = UINT64_MAX;
+    int members = 0; // the group is dropped with its last member
+};
+static std::unordered_map<std::string, LottieClockGroup> g_clock_groups;
+static inline void _clock_group_join(const String &group) {
+    if (group.is_empty()) return;
+    g_clock_groups[std::string(group.utf8().get_data())].members += 1;
+}
+static inline void _clock_group_leave(const String &group) {
+    if (group.is_empty()) return;
+    auto it = g_clock_groups.find(std::string(group.utf8().get_data()));
+    if (it != g_clock_groups.end()) {
+        it->second.members -= 1; if (it->second.members <= 0) g_clock_groups.erase(it);
+    }
+}
+
+// Advances a group's clock once per process frame, however many nodes read it.
+static double _advance_clock_group(const String &group, double delta) {
+    auto it = g_clock_groups.find(std::string(group.utf8().get_data()));
+    if (it == g_clock_groups.end()) return 0.0;
+    LottieClockGroup &g = it->second;
+    const uint64_t frame = Engine::get_singleton()->get_process_frames();
+    if (g.advanced_frame != frame) {
+        g.advanced_frame = frame;
+        g.time += delta;
+    }
+    return g.time;
+}
+
 void LottieAnimation::_parse_dotlottie_manifest(const String &zip_path) {
     last_lottie_zip_path = zip_path;
+    DotLottieBundle &bundle = _dotlottie_bundle(zip_path);
+    if (bundle.manifest_parsed) {
+        sm_animation_ids = bundle.animation_ids;
+        sm_machine_names = bundle.machine_names;
+        sm_states_by_machine = bundle.states_by_machine.duplicate(true);
+        sm_anim_inner_paths = bundle.anim_inner_paths.duplicate(true);
+        sm_state_segments_by_machine = bundle.state_segments_by_machine.duplicate(true);
+        sm_machine_sources = bundle.machine_sources.duplicate(true);
+    } else {
+        _read_dotlottie_manifest(zip_path);
+        bundle.animation_ids = sm_animation_ids;
+        bundle.machine_names = sm_machine_names;
+        bundle.states_by_machine = sm_states_by_machine.duplicate(true);
+        bundle.anim_inner_paths = sm_anim_inner_paths.duplicate(true);
+        bundle.state_segments_by_machine = sm_state_segments_by_machine.duplicate(true);
+        bundle.machine_sources = sm_machine_sources.duplicate(true);
+        bundle.manifest_parsed = true;
+    }
+
+    if (active_animation_id.is_empty() && sm_animation_ids.size() > 0) active_animation_id = sm_animation_ids[0];
+    if (active_state_machine.is_empty() && sm_machine_names.size() > 0) active_state_machine = sm_machine_names[0];
+    PackedStringArray sts;
+    if (sm_states_by_machine.has(active_state_machine)) sts = (PackedStringArray)sm_states_by_machine[active_state_machine];
+    if (active_state.is_empty() && sts.size() > 0) active_state = sts[0];
+    notify_property_list_changed();
+}
+
+void LottieAnimation::_read_dotlottie_manifest(const String &zip_path) {
     sm_animation_ids.clear();
     sm_machine_names.clear();
     sm_states_by_machine.clear();
     sm_anim_inner_paths.clear();
     sm_state_segments_by_machine.clear();
+    sm_machine_sources.clear();
 
     Ref<ZIPReader> zr;
     zr.instantiate();
@@ -486,6 +550,7 @@ void LottieAnimation::_parse_dotlottie_manifest(const String &zip_path) {
             PackedByteArray bytes2 = zr2->read_file(candidate_path);
             zr2->close();
             String text2 = bytes2.get_string_from_utf8();
+            sm_machine_sources[machine_name] = text2;
             Dictionary segs;
             out = parse_states_json_text(text2, segs);
             if (!out.is_empty()) {
@@ -501,17 +566,10 @@ void LottieAnimation::_parse_dotlottie_manifest(const String &zip_path) {
         String mname = sm_machine_names[i];
         PackedStringArray existing;
         if (sm_states_by_machine.has(mname)) existing = (PackedStringArray)sm_states_by_machine[mname];
-        if (existing.is_empty()) {
-            PackedStringArray states = try_load_states_for_machine(mname);
-            if (!states.is_empty()) sm_states_by_machine[mname] = states;
-        }
+        // Always read the machine JSON: the native runtime needs it even when the manifest lists states.
+        PackedStringArray states = try_load_states_for_machine(mname);
+        if (existing.is_empty() && !states.is_empty()) sm_states_by_machine[mname] = states;
     }
-    if (active_animation_id.is_empty() && sm_animation_ids.size() > 0) active_animation_id = sm_animation_ids[0];
-    if (active_state_machine.is_empty() && sm_machine_names.size() > 0) active_state_machine = sm_machine_names[0];
-    PackedStringArray sts;
-    if (sm_states_by_machine.has(active_state_machine)) sts = (PackedStringArray)sm_states_by_machine[active_state_machine];
-    if (active_state.is_empty() && sts.size() > 0) active_state = sts[0];
-    notify_property_list_changed();
 }
 
 String LottieAnimation::_extract_json_from_lottie_to_cache(const String &zip_path, const String &inner_path, const String &suffix_key) {
@@ -599,6 +657,20 @@ void LottieAnimation::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_animation_path"), &LottieAnimation::get_animation_path);
     ClassDB::bind_method(D_METHOD("set_selected_dotlottie_animation", "id_or_path"), &LottieAnimation::set_selected_dotlottie_animation);
     ClassDB::bind_method(D_METHOD("get_selected_dotlottie_animation"), &LottieAnimation::get_selected_dotlottie_animation);
+    ClassDB::bind_method(D_METHOD("preload_animation", "path"), &LottieAnimation::preload_animation);
+    ClassDB::bind_method(D_METHOD("crossfade_to", "path"), &LottieAnimation::crossfade_to);
+    ClassDB::bind_method(D_METHOD("set_crossfade_progress", "progress"), &LottieAnimation::set_crossfade_progress);
+    ClassDB::bind_method(D_METHOD("get_crossfade_progress"), &LottieAnimation::get_crossfade_progress);
+    ClassDB::bind_method(D_METHOD("finish_crossfade"), &LottieAnimation::finish_crossfade);
+    ClassDB::bind_method(D_METHOD("is_crossfading"), &LottieAnimation::is_crossfading);
+    ClassDB::bind_method(D_METHOD("start_state_machine", "machine"), &LottieAnimation::start_state_machine, DEFVAL(String()));
+    ClassDB::bind_method(D_METHOD("stop_state_machine"), &LottieAnimation::stop_state_machine);
+    ClassDB::bind_method(D_METHOD("is_state_machine_running"), &LottieAnimation::is_state_machine_running);
+    ClassDB::bind_method(D_METHOD("get_state_machine_state"), &LottieAnimation::get_state_machine_state);
+    ClassDB::bind_method(D_METHOD("set_state_machine_input", "name", "value"), &LottieAnimation::set_state_machine_input);
+    ClassDB::bind_method(D_METHOD("get_state_machine_input", "name"), &LottieAnimation::get_state_machine_input);
+    ClassDB::bind_method(D_METHOD("fire_state_machine_event", "name"), &LottieAnimation::fire_state_machine_event);
+    ClassDB::bind_method(D_METHOD("post_state_machine_pointer", "type", "position"), &LottieAnimation::post_state_machine_pointer);
     
     ClassDB::bind_method(D_METHOD("set_playing", "playing"), &LottieAnimation::set_playing);
     ClassDB::bind_method(D_METHOD("is_playing"), &LottieAnimation::is_playing);
@@ -627,35 +699,79 @@ void LottieAnimation::_bind_methods() {
     ClassDB::bind_method(D_METHOD("is_dynamic_resolution"), &LottieAnimation::is_dynamic_resolution);
     ClassDB::bind_method(D_METHOD("set_resolution_threshold", "threshold"), &LottieAnimation::set_resolution_threshold);
     ClassDB::bind_method(D_METHOD("get_resolution_threshold"), &LottieAnimation::get_resolution_threshold);
+    ClassDB::bind_method(D_METHOD("set_resolution_size_classes", "enable"), &LottieAnimation::set_resolution_size_classes);
+    ClassDB::bind_method(D_METHOD("is_resolution_size_classes"), &LottieAnimation::is_resolution_size_classes);
+    ClassDB::bind_method(D_METHOD("set_lookahead_frames", "frames"), &LottieAnimation::set_lookahead_frames);
+    ClassDB::bind_method(D_METHOD("get_lookahead_frames"), &LottieAnimation::get_lookahead_frames);
+    ClassDB::bind_method(D_METHOD("set_render_thread_enabled", "enable"), &LottieAnimation::set_render_thread_enabled);
+    ClassDB::bind_method(D_METHOD("is_render_thread_enabled"), &LottieAnimation::is_render_thread_enabled);
+    ClassDB::bind_method(D_METHOD("set_release_hidden_after", "seconds"), &LottieAnimation::set_release_hidden_after);
+    ClassDB::bind_method(D_METHOD("get_release_hidden_after"), &LottieAnimation::get_release_hidden_after);
+    ClassDB::bind_method(D_METHOD("set_progressive_resize", "enable"), &LottieAnimation::set_progressive_resize);
+    ClassDB::bind_method(D_METHOD("is_progressive_resize"), &LottieAnimation::is_progressive_resize);
+    ClassDB::bind_method(D_METHOD("set_progressive_settle_time", "seconds"), &LottieAnimation::set_progressive_settle_time);
+    ClassDB::bind_method(D_METHOD("get_progressive_settle_time"), &LottieAnimation::get_progressive_settle_time);
     ClassDB::bind_method(D_METHOD("set_max_render_size", "size"), &LottieAnimation::set_max_render_size);
     ClassDB::bind_method(D_METHOD("get_max_render_size"), &LottieAnimation::get_max_render_size);
     ClassDB::bind_method(D_METHOD("set_frame_cache_enabled", "enabled"), &LottieAnimation::set_frame_cache_enabled);
     ClassDB::bind_method(D_METHOD("is_frame_cache_enabled"), &LottieAnimation::is_frame_cache_enabled);
     ClassDB::bind_method(D_METHOD("set_frame_cache_budget_mb", "mb"), &LottieAnimation::set_frame_cache_budget_mb);
     ClassDB::bind_method(D_METHOD("get_frame_cache_budget_mb"), &LottieAnimation::get_frame_cache_budget_mb);
+    ClassDB::bind_method(D_METHOD("set_dotlottie_keep_resident", "keep"), &LottieAnimation::set_dotlottie_keep_resident);
+    ClassDB::bind_method(D_METHOD("is_dotlottie_keep_resident"), &LottieAnimation::is_dotlottie_keep_resident);
+    ClassDB::bind_method(D_METHOD("set_dotlottie_resident_budget_mb", "mb"), &LottieAnimation::set_dotlottie_resident_budget_mb);
+    ClassDB::bind_method(D_METHOD("get_dotlottie_resident_budget_mb"), &LottieAnimation::get_dotlottie_resident_budget_mb);
     ClassDB::bind_method(D_METHOD("set_frame_cache_step", "frames"), &LottieAnimation::set_frame_cache_step);
     ClassDB::bind_method(D_METHOD("get_frame_cache_step"), &LottieAnimation::get_frame_cache_step);
+    ClassDB::bind_method(D_METHOD("set_loop_bake_enabled", "enabled"), &LottieAnimation::set_loop_bake_enabled);
+    ClassDB::bind_method(D_METHOD("is_loop_bake_enabled"), &LottieAnimation::is_loop_bake_enabled);
+    ClassDB::bind_method(D_METHOD("set_loop_bake_budget_mb", "mb"), &LottieAnimation::set_loop_bake_budget_mb);
+    ClassDB::bind_method(D_METHOD("get_loop_bake_budget_mb"), &LottieAnimation::get_loop_bake_budget_mb);
+    ClassDB::bind_method(D_METHOD("is_loop_baked"), &LottieAnimation::is_loop_baked);
+    ClassDB::bind_method(D_METHOD("set_disk_cache_enabled", "enabled"), &LottieAnimation::set_disk_cache_enabled);
+    ClassDB::bind_method(D_METHOD("is_disk_cache_enabled"), &LottieAnimation::is_disk_cache_enabled);
+    ClassDB::bind_method(D_METHOD("set_disk_cache_budget_mb", "mb"), &LottieAnimation::set_disk_cache_budget_mb);
+    ClassDB::bind_method(D_METHOD("get_disk_cache_budget_mb"), &LottieAnimation::get_disk_cache_budget_mb);
     ClassDB::bind_method(D_METHOD("set_engine_option", "opt"), &LottieAnimation::set_engine_option);
     ClassDB::bind_method(D_METHOD("get_engine_option"), &LottieAnimation::get_engine_option);
     // Static rendering when idle is now unconditional; only expose render_static() helper.
     ClassDB::bind_method(D_METHOD("render_static"), &LottieAnimation::render_static);
     
+    ClassDB::bind_method(D_METHOD("prewarm", "frame_begin", "frame_end", "size"), &LottieAnimation::prewarm, DEFVAL(Vector2i()));
+    ClassDB::bind_method(D_METHOD("prewarm_marker", "marker", "size"), &LottieAnimation::prewarm_marker, DEFVAL(Vector2i()));
+    ClassDB::bind_method(D_METHOD("is_prewarming"), &LottieAnimation::is_prewarming);
+    ClassDB::bind_method(D_METHOD("bake_frame_stream", "output_path", "size", "keyframe_interval"), &LottieAnimation::bake_frame_stream, DEFVAL(Vector2i()), DEFVAL(30));
     ClassDB::bind_method(D_METHOD("get_duration"), &LottieAnimation::get_duration);
     ClassDB::bind_method(D_METHOD("get_total_frames"), &LottieAnimation::get_total_frames);
     ClassDB::bind_method(D_METHOD("set_culling_mode", "mode"), &LottieAnimation::set_culling_mode);
     ClassDB::bind_method(D_METHOD("get_culling_mode"), &LottieAnimation::get_culling_mode);
     ClassDB::bind_method(D_METHOD("set_culling_margin_px", "margin"), &LottieAnimation::set_culling_margin_px);
     ClassDB::bind_method(D_METHOD("get_culling_margin_px"), &LottieAnimation::get_culling_margin_px);
+    ClassDB::bind_method(D_METHOD("set_clock_group", "group"), &LottieAnimation::set_clock_group);
+    ClassDB::bind_method(D_METHOD("get_clock_group"), &LottieAnimation::get_clock_group);
+    ClassDB::bind_method(D_METHOD("set_clock_phase", "phase"), &LottieAnimation::set_clock_phase);
+    ClassDB::bind_method(D_METHOD("get_clock_phase"), &LottieAnimation::get_clock_phase);
+    ClassDB::bind_method(D_METHOD("set_phase_buckets", "buckets"), &LottieAnimation::set_phase_buckets);
+    ClassDB::bind_method(D_METHOD("get_phase_buckets"), &LottieAnimation::get_phase_buckets);
     ClassDB::bind_method(D_METHOD("_on_viewport_size_changed"), &LottieAnimation::_on_viewport_size_changed);
     ClassDB::bind_method(D_METHOD("set_offset", "offset"), &LottieAnimation::set_offset);
     ClassDB::bind_method(D_METHOD("get_offset"), &LottieAnimation::get_offset);
     
     // Properties
-    ADD_PROPERTY(PropertyInfo(Variant::STRING, "animation_path", PROPERTY_HINT_FILE, "*.json,*.lottie"), 
+    ADD_PROPERTY(PropertyInfo(Variant::STRING, "animation_path", PROPERTY_HINT_FILE, "*.json,*.lottie,*.lottieframes"), 
                  "set_animation_path", "get_animation_path");
     // Selection helper for .lottie bundles (hidden from inspector; controlled by plugin UI)
     ADD_PROPERTY(PropertyInfo(Variant::STRING, "dotlottie/selected_animation", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_STORAGE | PROPERTY_USAGE_NO_EDITOR),
                  "set_selected_dotlottie_animation", "get_selected_dotlottie_animation");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "dotlottie/keep_resident"), "set_dotlottie_keep_resident", "is_dotlottie_keep_resident");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "dotlottie/resident_budget_mb", PROPERTY_HINT_RANGE, "1,1024,1"), "set_dotlottie_resident_budget_mb", "get_dotlottie_resident_budget_mb");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "frame_cache/bake_loop"), "set_loop_bake_enabled", "is_loop_bake_enabled");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "frame_cache/bake_budget_mb", PROPERTY_HINT_RANGE, "1,1024,1"), "set_loop_bake_budget_mb", "get_loop_bake_budget_mb");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "frame_cache/disk_enabled"), "set_disk_cache_enabled", "is_disk_cache_enabled");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "frame_cache/disk_budget_mb", PROPERTY_HINT_RANGE, "16,8192,16"), "set_disk_cache_budget_mb", "get_disk_cache_budget_mb");
+    ADD_PROPERTY(PropertyInfo(Variant::STRING, "clock/group"), "set_clock_group", "get_clock_group");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "clock/phase", PROPERTY_HINT_RANGE, "0.0,1.0,0.001"), "set_clock_phase", "get_clock_phase");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "clock/phase_buckets", PROPERTY_HINT_RANGE, "0,64,1"), "set_phase_buckets", "get_phase_buckets");
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "playing"), "set_playing", "is_playing");
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "autoplay"), "set_autoplay", "is_autoplay");
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "looping"), "set_looping", "is_looping");
@@ -667,6 +783,12 @@ void LottieAnimation::_bind_methods() {
     ADD_PROPERTY(PropertyInfo(Variant::VECTOR2I, "fit_box_size"), "set_fit_box_size", "get_fit_box_size");
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "dynamic_resolution"), "set_dynamic_resolution", "is_dynamic_resolution");
     ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "resolution_threshold", PROPERTY_HINT_RANGE, "0.01,1.0,0.01"), "set_resolution_threshold", "get_resolution_threshold");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "resolution_size_classes"), "set_resolution_size_classes", "is_resolution_size_classes");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "lookahead_frames", PROPERTY_HINT_RANGE, "0,8,1"), "set_lookahead_frames", "get_lookahead_frames");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "render_thread_enabled"), "set_render_thread_enabled", "is_render_thread_enabled");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "release_hidden_after", PROPERTY_HINT_RANGE, "0.0,600.0,0.5"), "set_release_hidden_after", "get_release_hidden_after");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "progressive_resize"), "set_progressive_resize", "is_progressive_resize");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "progressive_settle_time", PROPERTY_HINT_RANGE, "0.0,2.0,0.01"), "set_progressive_settle_time", "get_progressive_settle_time");
     ADD_PROPERTY(PropertyInfo(Variant::VECTOR2I, "max_render_size", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_STORAGE | PROPERTY_USAGE_NO_EDITOR), "set_max_render_size", "get_max_render_size");
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "frame_cache/enabled", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_STORAGE | PROPERTY_USAGE_NO_EDITOR), "set_frame_cache_enabled", "is_frame_cache_enabled");
     ADD_PROPERTY(PropertyInfo(Variant::INT, "frame_cache/budget_mb", PROPERTY_HINT_RANGE, "16,4096,16", PROPERTY_USAGE_STORAGE | PROPERTY_USAGE_NO_EDITOR), "set_frame_cache_budget_mb", "get_frame_cache_budget_mb");
@@ -678,6 +800,10 @@ void LottieAnimation::_bind_methods() {
     ADD_SIGNAL(MethodInfo("animation_finished"));
     ADD_SIGNAL(MethodInfo("frame_changed", PropertyInfo(Variant::FLOAT, "frame")));
     ADD_SIGNAL(MethodInfo("animation_loaded", PropertyInfo(Variant::BOOL, "success")));
+    ADD_SIGNAL(MethodInfo("prewarm_finished", PropertyInfo(Variant::INT, "frame_begin"), PropertyInfo(Variant::INT, "frame_end")));
+    ADD_SIGNAL(MethodInfo("state_machine_state_entered", PropertyInfo(Variant::STRING, "state")));
+    ADD_SIGNAL(MethodInfo("state_machine_state_exited", PropertyInfo(Variant::STRING, "state")));
+    ADD_SIGNAL(MethodInfo("state_machine_custom_event", PropertyInfo(Variant::STRING, "message")));
 }
 
 LottieAnimation::LottieAnimation() {
@@ -710,17 +836,29 @@ LottieAnimation::LottieAnimation() {
 #ifdef __EMSCRIPTEN__
     render_thread_enabled = false;
 #endif
-    _initialize_thorvg();
+    // Canvas, buffers and the worker thread are created by the first load (see _ensure_resources).
 }
 
 LottieAnimation::~LottieAnimation() {
+    LottieRenderScheduler::get_singleton()->cancel(this);
     // Decrement usage for current animation key
     if (!animation_key.is_empty()) _registry_dec(animation_key);
+    _clock_group_leave(clock_group);
+    _wait_prewarm();
+    _release_crossfade_source();
+    if (crossfade_item.is_valid()) {
+        RenderingServer::get_singleton()->free_rid(crossfade_item);
+        crossfade_item = RID();
+    }
+    _invalidate_loop_bake();
     _cleanup_thorvg();
 }
 
-void LottieAnimation::_initialize_thorvg() {
+void LottieAnimation::ensure_thorvg_initialized() {
+    // The preloader and resident pool parse on their own threads; the first caller initializes.
+    static std::mutex init_mutex;
     static bool thorvg_initialized = false;
+    std::lock_guard<std::mutex> lk(init_mutex);
     if (!thorvg_initialized) {
         unsigned int hw_threads = std::thread::hardware_concurrency();
         unsigned int threads = hw_threads;
@@ -741,7 +879,42 @@ void LottieAnimation::_initialize_thorvg() {
         UtilityFunctions::print("ThorVG initialized successfully! Active threads:", threads);
         thorvg_initialized = true;
     }
-    
+}
+
+String LottieAnimation::resolve_source_path(const String &path) {
+    if (!path.to_lower().ends_with(".lottie")) return path;
+    return _extract_lottie_json_to_cache(path);
+}
+
+String LottieAnimation::mirror_source_to_user_cache(const String &path) {
+    return _mirror_file_to_user_cache(path);
+}
+
+String LottieAnimation::load_picture(tvg::Picture *picture, const String &path) {
+    String abs_path = ProjectSettings::get_singleton()->globalize_path(path);
+    if (picture->load(abs_path.utf8().get_data()) == tvg::Result::Success) return abs_path;
+    // Files inside the PCK (e.g. on Web) cannot be opened by path; mirror to user:// and retry.
+    String mirrored = _mirror_file_to_user_cache(path);
+    if (mirrored.is_empty()) return String();
+    abs_path = ProjectSettings::get_singleton()->globalize_path(mirrored);
+    return picture->load(abs_path.utf8().get_data()) == tvg::Result::Success ? abs_path : String();
+}
+
+void LottieAnimation::fit_picture(tvg::Picture *picture, const Vector2i &base_size, const Vector2i &size) {
+    const float pw = std::max(1.0f, (float)base_size.x);
+    const float ph = std::max(1.0f, (float)base_size.y);
+    const float s = std::min((float)size.x / pw, (float)size.y / ph);
+    // Compose absolute transform matrix to avoid cumulative state
+    tvg::Matrix m;
+    m.e11 = s;   m.e12 = 0.0f; m.e13 = (size.x - pw * s) * 0.5f;
+    m.e21 = 0.0f; m.e22 = s;   m.e23 = (size.y - ph * s) * 0.5f;
+    m.e31 = 0.0f; m.e32 = 0.0f; m.e33 = 1.0f;
+    picture->transform(m);
+}
+
+void LottieAnimation::_initialize_thorvg() {
+    ensure_thorvg_initialized();
+
     tvg::EngineOption render_opt = tvg::EngineOption::Default;
     if (engine_option == 1) render_opt = tvg::EngineOption::SmartRender;
     
@@ -750,24 +923,97 @@ void LottieAnimation::_initialize_thorvg() {
         UtilityFunctions::printerr("Failed to create ThorVG canvas");
         return;
     }
-    
-    _allocate_buffer_and_target(render_size);
+    // The render target is sized by the load (_apply_sizing_policy).
     // Only start worker when enabled (never on Web by default)
     _start_worker_if_needed();
 }
 
-void LottieAnimation::_cleanup_thorvg() {
+bool LottieAnimation::_ensure_resources() {
+    if (frame_stream) {
+        if (resources_released) _restore_resources();
+        return true;
+    }
+    if (!canvas) _initialize_thorvg();
+    if (canvas && resources_released) _restore_resources();
+    return canvas != nullptr;
+}
+
+void LottieAnimation::_release_hidden_resources() {
+    if (resources_released || (!canvas && !frame_stream)) return;
+    if (crossfading) finish_crossfade();
     _stop_worker();
-    if (picture && animation) {
-        canvas->remove();
+    _cancel_slice();
+    {
+        std::lock_guard<std::mutex> lk(frame_mutex);
+        latest_frame.ready = false;
+        latest_frame.rgba = std::vector<uint8_t>();
+    }
+    LottieBufferPool *pool = LottieBufferPool::get_singleton();
+    if (buffer) { pool->release_pixels(buffer, render_size); buffer = nullptr; }
+    main_tiles_texture.unref();
+    worker_upload_texture.unref();
+    texture.unref();
+    for (Ref<ImageTexture> &tex : texture_ring) pool->release_texture(tex);
+    texture_ring.clear();
+    texture_ring_index = 0;
+    image.unref();
+    pixel_bytes = PackedByteArray();
+    main_tiles.invalidate();
+    _invalidate_loop_bake();
+    first_frame_drawn = false;
+    last_rendered_qf = -1;
+    last_posted_qf = -1;
+    last_posted_size = Vector2i(0, 0);
+    resources_released = true;
+}
+
+void LottieAnimation::_restore_resources() {
+    resources_released = false;
+    if (frame_stream) {
+        _create_texture(); // streams only need the staging image and a texture
+        return;
+    }
+    if (!picture) return;
+    _allocate_buffer_and_target(render_size);
+    _apply_picture_transform_to_fit();
+    _start_worker_if_needed();
+    _repost_worker_state();
+}
+
+void LottieAnimation::_repost_worker_state() {
+    if (!render_thread_enabled || worker_load_path.is_empty()) return;
+    // A new worker starts empty; reload the animation and reapply the active segment.
+    _post_load_to_worker(worker_load_path);
+    float sb = 0.0f, se = 0.0f;
+    if (segment_applied && animation && animation->segment(&sb, &se) == tvg::Result::Success) {
+        _post_segment_to_worker(sb, se);
+    }
+}
+
+void LottieAnimation::_load_deferred() {
+    if (!load_deferred) return;
+    load_deferred = false;
+    if (animation_path.is_empty() || animation || frame_stream) return;
+    if (_load_animation(animation_path)) {
+        if (autoplay) {
+            play();
+        } else {
+            render_static();
+        }
     }
+}
+
+void LottieAnimation::_cleanup_thorvg() {
+    _stop_worker();
+    _release_animation();
+    _update_resident_bundle(String());
     
     if (canvas) {
         delete canvas;
         canvas = nullptr;
     }
     
-    if (buffer) { delete[] buffer; buffer = nullptr; }
+    if (buffer) { LottieBufferPool::get_singleton()->release_pixels(buffer, render_size); buffer = nullptr; }
     
     animation = nullptr;
     picture = nullptr;
@@ -778,31 +1024,32 @@ bool LottieAnimation::_load_animation(const String& path) {
         return false;
     }
     
-    if (!canvas) {
+    load_deferred = false;
+    _wake(); // the load finishes (worker frame, upload) over the next ticks
+    frame_stream.reset();
+    if (path.to_lower().ends_with(".lottieframes")) {
+        return _load_frame_stream(path);
+    }
+    if (!_ensure_resources()) {
         UtilityFunctions::printerr("ThorVG canvas not initialized");
         return false;
     }
     
-    if (picture) {
-    canvas->remove();
-        picture = nullptr;
-        animation = nullptr;
+    // The outgoing animation returns to the bundle pool before switching bundles closes it.
+    const bool had_picture = picture != nullptr;
+    _release_animation();
+    _update_resident_bundle(path);
+
+    if (had_picture) {
         if (buffer) memset(buffer, 0, (size_t)render_size.x * (size_t)render_size.y * sizeof(uint32_t));
         if (image.is_valid()) {
             pixel_bytes.fill(0);
             image->set_data(render_size.x, render_size.y, false, Image::FORMAT_RGBA8, pixel_bytes);
+            main_tiles.invalidate();
             if (texture.is_valid()) texture->update(image);
         }
     }
     
-    animation = tvg::Animation::gen();
-    picture = animation->picture();
-    
-    if (!picture) {
-        UtilityFunctions::printerr("Failed to create ThorVG picture");
-        return false;
-    }
-    
     // Load the Lottie file (.json/.lot) or handle .lottie (zip) by extracting the JSON
     String source_path = path;
     String lower = path.to_lower();
@@ -825,18 +1072,34 @@ bool LottieAnimation::_load_animation(const String& path) {
         source_path = extracted;
     }
 
-    // Try direct load; if it fails (e.g., file is inside the PCK on Web), mirror to user:// and retry.
-    auto _try_load_path = [&](const String &p) -> bool {
-        String ap = ProjectSettings::get_singleton()->globalize_path(p);
-        return picture->load(ap.utf8().get_data()) == tvg::Result::Success;
-    };
+    // A resident animation from this bundle is swapped back in without parsing;
+    // otherwise adopt one the preloader already parsed in the background, if waiting.
+    tvg::Animation *resident = LottieResidentPool::get_singleton()->take(std::string(ProjectSettings::get_singleton()->globalize_path(source_path).utf8().get_data()));
+    LottiePreloader::Prepared prepared;
+    // The worker copy is handed over below; any early return (or no worker) frees it here.
+    struct _WorkerCopyGuard { tvg::Animation *&anim; ~_WorkerCopyGuard(){ delete anim; } } _worker_copy_guard{ prepared.worker_animation };
+    const bool use_prepared = !resident && LottiePreloader::get_singleton()->take(source_path, prepared);
+    if (resident) {
+        animation = resident;
+    } else if (use_prepared) {
+        animation = prepared.animation;
+        prepared.animation = nullptr;
+    } else {
+        animation = tvg::Animation::gen();
+    }
+    picture = animation->picture();
+
+    if (!picture) {
+        UtilityFunctions::printerr("Failed to create ThorVG picture");
+        return false;
+    }
 
-    bool loaded_ok = _try_load_path(source_path);
+    bool loaded_ok = resident || use_prepared;
+    loaded_abs_path = ProjectSettings::get_singleton()->globalize_path(source_path);
     if (!loaded_ok) {
-        String mirrored = _mirror_file_to_user_cache(source_path);
-        if (!mirrored.is_empty()) {
-            loaded_ok = _try_load_path(mirrored);
-        }
+        String abs_path = load_picture(picture, source_path);
+        loaded_ok = !abs_path.is_empty();
+        if (loaded_ok) loaded_abs_path = abs_path;
     }
     if (!loaded_ok) {
         UtilityFunctions::printerr("Failed to load Lottie animation: " + source_path);
@@ -848,12 +1111,19 @@ bool LottieAnimation::_load_animation(const String& path) {
     }
     animation_key = source_path; // cache key base
     _registry_inc(animation_key);
+    // Markers are indexed once per file and shared; segment switches become map lookups.
+    anim_info = LottieAnimationIndex::get_singleton()->get_info(source_path);
     _recompute_live_cache_state();
     
     // Get animation info
     duration = animation->duration();
     total_frames = animation->totalFrame();
     current_frame = 0.0f;
+    last_rendered_qf = -1;
+    segment_applied = false;
+    segment_key = String();
+    _invalidate_loop_bake();
+    disk_cache_key = String();
     
     // Query intrinsic size and set sizing policy
     float pw = 0.0f, ph = 0.0f;
@@ -873,15 +1143,19 @@ bool LottieAnimation::_load_animation(const String& path) {
     }
     
     _create_texture();
+    // A preloaded first frame at the current target size can be shown without rasterizing.
+    const bool shown_prepared = use_prepared && _upload_prepared_frame(prepared);
     if (render_thread_enabled) {
-        _post_load_to_worker(source_path);
+        // The preloader's second copy spares the worker a parse of its own.
+        _post_load_to_worker(source_path, prepared.worker_animation);
+        prepared.worker_animation = nullptr;
         _post_render_to_worker(render_size, current_frame);
-    } else {
+    } else if (!shown_prepared) {
         _render_frame(); // Draw initial frame immediately
     }
     // Ensure first frame shows even if not playing (static usage)
     if (!playing) {
-        _render_frame();
+        if (!shown_prepared) _render_frame();
         queue_redraw();
     }
     // Apply any selected state segment after load
@@ -893,43 +1167,278 @@ bool LottieAnimation::_load_animation(const String& path) {
     return true;
 }
 
+bool LottieAnimation::_load_frame_stream(const String &path) {
+    // Streams never rasterize: no canvas, ARGB buffer or render thread, only the image and texture.
+    if (lookahead_active) _clear_lookahead();
+    _cancel_slice();
+    _cleanup_thorvg();
+    worker_load_path = String();
+    anim_info.reset();
+    _invalidate_loop_bake();
+    std::unique_ptr<LottieFrameStream> stream(new LottieFrameStream());
+    bool opened = stream->open(ProjectSettings::get_singleton()->globalize_path(path));
+    if (!opened) {
+        // Packed in a PCK: mmap needs a real file, so mirror it to user:// first.
+        String mirrored = _mirror_file_to_user_cache(path);
+        opened = !mirrored.is_empty() && stream->open(ProjectSettings::get_singleton()->globalize_path(mirrored));
+    }
+    if (!opened) {
+        UtilityFunctions::printerr("Failed to open Lottie frame stream: " + path);
+        emit_signal("animation_loaded", false);
+        return false;
+    }
+    const Vector2i stream_size = stream->get_size();
+    if (stream_size.x > max_render_size.x || stream_size.y > max_render_size.y) {
+        UtilityFunctions::printerr("Lottie frame stream is larger than max_render_size: " + path);
+        emit_signal("animation_loaded", false);
+        return false;
+    }
+    render_size = stream_size;
+    pixel_bytes = PackedByteArray();
+    main_tiles.invalidate();
+    _create_texture();
+    if (!animation_key.is_empty() && animation_key != path) {
+        _registry_dec(animation_key);
+    }
+    animation_key = path;
+    _registry_inc(animation_key);
+    total_frames = (float)stream->get_frame_count();
+    duration = total_frames / stream->get_fps();
+    current_frame = 0.0f;
+    last_rendered_qf = -1;
+    first_frame_drawn = false;
+    frame_stream = std::move(stream);
+    _render_stream_frame();
+    queue_redraw();
+    emit_signal("animation_loaded", true);
+    return true;
+}
+
+void LottieAnimation::_render_stream_frame() {
+    if (!frame_stream || !image.is_valid()) return;
+    const int qf = _quantized_frame_index();
+    if (first_frame_drawn && qf == last_rendered_qf) return;
+    const PackedByteArray *rgba = frame_stream->decode(qf);
+    if (!rgba) {
+        UtilityFunctions::printerr("Corrupt Lottie frame stream: " + animation_key);
+        frame_stream.reset();
+        return;
+    }
+    main_tiles.invalidate();
+    image->set_data(render_size.x, render_size.y, false, Image::FORMAT_RGBA8, *rgba);
+    _upload_image_to_ring();
+    last_rendered_qf = qf;
+    first_frame_drawn = true;
+    _uploaded_this_frame = true;
+}
+
+bool LottieAnimation::bake_frame_stream(const String &output_path, const Vector2i &size, int keyframe_interval) {
+    if (!animation || loaded_abs_path.is_empty() || total_frames <= 0 || duration <= 0.0f) {
+        UtilityFunctions::printerr("bake_frame_stream: no vector animation loaded");
+        return false;
+    }
+    const Vector2i target = (size.x > 0 && size.y > 0) ? size : render_size;
+    const int count = (int)total_frames;
+    // Private canvas, so baking doesn't disturb the node's own playback state.
+    tvg::Animation *anim = tvg::Animation::gen();
+    tvg::Picture *pic = anim ? anim->picture() : nullptr;
+    if (!pic || pic->load(loaded_abs_path.utf8().get_data()) != tvg::Result::Success) {
+        if (anim) delete anim;
+        UtilityFunctions::printerr("bake_frame_stream: failed to load " + animation_key);
+        return false;
+    }
+    tvg::SwCanvas *cv = tvg::SwCanvas::gen();
+    std::vector<uint32_t> argb((size_t)target.x * (size_t)target.y, 0u);
+    std::vector<uint8_t> rgba(argb.size() * 4);
+    LottieFrameStreamWriter writer;
+    bool ok = cv && writer.begin(output_path, target, count, total_frames / duration, keyframe_interval);
+    if (ok) {
+        cv->target(argb.data(), target.x, target.x, target.y, tvg::ColorSpace::ARGB8888S);
+        fit_picture(pic, base_picture_size, target);
+        ok = cv->push(pic) == tvg::Result::Success;
+    }
+    for (int f = 0; ok && f < count; ++f) {
+        anim->frame((float)f);
+        cv->update();
+        cv->draw(false);
+        cv->sync();
+        lottie_convert_argb_to_rgba(argb.data(), rgba.data(), argb.size());
+        if (unpremultiply_alpha) _unpremultiply_alpha_rgba(rgba.data(), target.x, target.y);
+        if (fix_alpha_border) _fix_alpha_border_rgba(rgba.data(), target.x, target.y);
+        ok = writer.add_frame(rgba.data());
+    }
+    ok = writer.finish() && ok;
+    if (cv) delete cv;
+    delete anim;
+    if (!ok) UtilityFunctions::printerr("bake_frame_stream: failed to write " + output_path);
+    return ok;
+}
+
+bool LottieAnimation::_upload_prepared_frame(LottiePreloader::Prepared &prepared) {
+    if (prepared.frame_size != render_size || prepared.first_frame_rgba.empty() || !image.is_valid()) return false;
+    const int64_t bytes_needed = (int64_t)render_size.x * (int64_t)render_size.y * 4;
+    if ((int64_t)prepared.first_frame_rgba.size() != bytes_needed) return false;
+    if (pixel_bytes.size() != bytes_needed) pixel_bytes.resize(bytes_needed);
+    memcpy(pixel_bytes.ptrw(), prepared.first_frame_rgba.data(), (size_t)bytes_needed);
+    main_tiles.invalidate();
+    if (unpremultiply_alpha) {
+        _unpremultiply_alpha_rgba(pixel_bytes.ptrw(), render_size.x, render_size.y);
+    }
+    if (fix_alpha_border) {
+        _fix_alpha_border_rgba(pixel_bytes.ptrw(), render_size.x, render_size.y);
+    }
+    image->set_data(render_size.x, render_size.y, false, Image::FORMAT_RGBA8, pixel_bytes);
+    _upload_image_to_ring();
+    last_rendered_qf = _quantized_frame_index();
+    first_frame_drawn = true;
+    _uploaded_this_frame = true;
+    return true;
+}
+
+void LottieAnimation::_release_animation() {
+    if (picture && canvas) canvas->remove();
+    // Back to the bundle pool when resident, freed otherwise.
+    if (animation) LottieResidentPool::get_singleton()->give(std::string(loaded_abs_path.utf8().get_data()), animation, total_frames);
+    animation = nullptr;
+    picture = nullptr;
+}
+
+void LottieAnimation::_update_resident_bundle(const String &path) {
+    const bool keep = dotlottie_keep_resident && path.to_lower().ends_with(".lottie");
+    if (keep && path == resident_bundle_path) return;
+    LottieResidentPool *pool = LottieResidentPool::get_singleton();
+    if (!resident_bundle_path.is_empty()) pool->close_bundle(std::string(resident_bundle_path.utf8().get_data()));
+    resident_bundle_path = String();
+    if (!keep) return;
+    DotLottieBundle &bundle = _dotlottie_bundle(path);
+    if (!bundle.extracted && !_extract_lottie_bundle(path, bundle)) return;
+    resident_bundle_path = path;
+    pool->open_bundle(std::string(path.utf8().get_data()), bundle.resident_sources,
+            (size_t)dotlottie_resident_budget_mb * 1024ull * 1024ull, render_thread_enabled ? 2 : 1);
+}
+
+void LottieAnimation::set_dotlottie_keep_resident(bool p_keep) {
+    dotlottie_keep_resident = p_keep;
+    if (!p_keep) _update_resident_bundle(String());
+}
+
+bool LottieAnimation::is_dotlottie_keep_resident() const { return dotlottie_keep_resident; }
+void LottieAnimation::set_dotlottie_resident_budget_mb(int p_mb) { dotlottie_resident_budget_mb = std::max(1, p_mb); }
+int LottieAnimation::get_dotlottie_resident_budget_mb() const { return dotlottie_resident_budget_mb; }
+
+void LottieAnimation::preload_animation(const String &path) {
+    // Bundles need extraction on the main thread first; only plain JSON sources are preloaded.
+    if (path.is_empty() || path.to_lower().ends_with(".lottie")) return;
+    if (path == animation_key) return;
+    Vector2i size(std::min(fit_box_size.x, max_render_size.x), std::min(fit_box_size.y, max_render_size.y));
+    LottiePreloader::get_singleton()->request(path, size, render_thread_enabled);
+}
+
 void LottieAnimation::_create_texture() {
+    // Image::create zero-fills, so the image is already transparent (no white flash before the first upload)
     image = Image::create(render_size.x, render_size.y, false, Image::FORMAT_RGBA8);
-    // Initialize to transparent to avoid white flash during rapid resizes before first frame upload
-    if (image.is_valid()) {
-        image->fill(Color(0, 0, 0, 0));
-    }
+    if (image.is_null()) return;
     _recreate_texture_ring();
 }
 
 void LottieAnimation::_recreate_texture_ring() {
+    LottieBufferPool *pool = LottieBufferPool::get_singleton();
+    // These only mark which slot holds what; drop them so idle slots can go back to the pool.
+    main_tiles_texture.unref();
+    worker_upload_texture.unref();
+    for (Ref<ImageTexture> &tex : texture_ring) pool->release_texture(tex);
     texture_ring.clear();
-    texture_ring.reserve(std::max(2, texture_ring_size));
-    for (int i = 0; i < std::max(2, texture_ring_size); ++i) {
-        Ref<ImageTexture> tex = ImageTexture::create_from_image(image);
-        texture_ring.push_back(tex);
+    // One blank slot to show right away; the rest are leased by _upload_image_to_ring when needed.
+    Ref<ImageTexture> tex = pool->acquire_texture(Vector2i(image->get_width(), image->get_height()));
+    if (tex.is_null()) {
+        tex = ImageTexture::create_from_image(image);
+    } else {
+        tex->update(image);
+    }
+    texture_ring.push_back(tex);
+    texture_ring_index = 0;
+    texture = tex;
+}
+
+int LottieAnimation::_texture_ring_depth() const {
+    // Paused and single-frame nodes update their one texture in place; only continuous playback
+    // needs extra slots so an upload never touches the texture being drawn.
+    if (!playing || total_frames <= 1.0f) return 1;
+    return std::max(2, texture_ring_size);
+}
+
+void LottieAnimation::_shrink_texture_ring(int depth) {
+    if ((int)texture_ring.size() <= depth) return;
+    // Keep the texture on screen as slot 0
+    for (size_t i = 1; i < texture_ring.size(); i++) {
+        if (texture_ring[i] == texture) std::swap(texture_ring[0], texture_ring[i]);
     }
+    LottieBufferPool *pool = LottieBufferPool::get_singleton();
+    for (size_t i = (size_t)depth; i < texture_ring.size(); i++) {
+        if (main_tiles_texture == texture_ring[i]) main_tiles_texture.unref();
+        if (worker_upload_texture == texture_ring[i]) worker_upload_texture.unref();
+        pool->release_texture(texture_ring[i]);
+    }
+    texture_ring.resize((size_t)depth);
     texture_ring_index = 0;
-    if (!texture_ring.empty()) texture = texture_ring[0];
+}
+
+void LottieAnimation::_upload_image_to_ring() {
+    if (image.is_null()) return;
+    const int depth = _texture_ring_depth();
+    _shrink_texture_ring(depth);
+    if ((int)texture_ring.size() < depth) texture_ring.resize((size_t)depth);
+    if (texture_ring_index >= (int)texture_ring.size()) texture_ring_index = 0;
+    Ref<ImageTexture> &slot = texture_ring[texture_ring_index];
+    const Vector2i size(image->get_width(), image->get_height());
+    if (slot.is_valid() && (slot->get_width() != size.x || slot->get_height() != size.y)) {
+        LottieBufferPool::get_singleton()->release_texture(slot);
+    }
+    if (slot.is_null()) slot = LottieBufferPool::get_singleton()->acquire_texture(size);
+    if (slot.is_null()) {
+        slot = ImageTexture::create_from_image(image);
+    } else {
+        slot->update(image);
+    }
+    texture = slot;
+    texture_ring_index = (texture_ring_index + 1) % (int)texture_ring.size();
 }
 
 void LottieAnimation::_update_animation(float delta) {
-    if (!playing || !animation || total_frames <= 0) {
+    if (!playing || (!animation && !frame_stream) || total_frames <= 0) {
         return;
     }
     
     // Update current frame
     float prev_frame = current_frame;
+    if (!clock_group.is_empty() && looping && duration > 0.0f) {
+        // Looping nodes in a group show the group time plus their phase; with phase buckets the
+        // whole crowd collapses onto a handful of distinct frames that caches can share.
+        float phase = clock_phase - std::floor(clock_phase);
+        if (phase_buckets > 0) phase = std::round(phase * phase_buckets) / (float)phase_buckets;
+        const double t = _advance_clock_group(clock_group, delta);
+        const double raw = t * (total_frames / duration) * speed + (double)phase * total_frames;
+        current_frame = (float)std::fmod(raw, (double)total_frames);
+        if (current_frame < prev_frame) {
+            _post_dotlottie_sm_interaction(LottieDotLottieStateMachine::INTERACTION_ON_LOOP_COMPLETE);
+        }
+        if ((int)prev_frame != (int)current_frame) {
+            emit_signal("frame_changed", current_frame);
+        }
+        return;
+    }
     current_frame += (total_frames / duration) * delta * speed;
     
     // Handle looping
     if (current_frame >= total_frames) {
         if (looping) {
             current_frame = fmod(current_frame, total_frames);
+            _post_dotlottie_sm_interaction(LottieDotLottieStateMachine::INTERACTION_ON_LOOP_COMPLETE);
         } else {
             current_frame = total_frames - 1;
             playing = false;
             emit_signal("animation_finished");
+            _post_dotlottie_sm_interaction(LottieDotLottieStateMachine::INTERACTION_ON_COMPLETE);
         }
     }
     
@@ -940,6 +1449,10 @@ void LottieAnimation::_update_animation(float delta) {
 }
 
 void LottieAnimation::_render_frame() {
+    if (frame_stream) {
+        _render_stream_frame();
+        return;
+    }
     // Reentrancy guard to avoid nested renders during rapid editor events.
     if (rendering) {
         return;
@@ -955,16 +1468,16 @@ void LottieAnimation::_render_frame() {
     if (first_frame_drawn && !pending_resize && qf_now == last_rendered_qf) {
         return;
     }
-    // Cache fast-path: if enabled, try to reuse a shared texture
-    if (frame_cache_enabled && (!cache_only_when_paused || !playing ? true : false)) {
-        _ensure_cache_capacity();
-        int qf = _quantized_frame_index();
-        Ref<ImageTexture> cached = LottieFrameCache::get_singleton()->get(animation_key, qf, render_size);
-        if (cached.is_valid()) {
-            texture = cached;
-            _uploaded_this_frame = true; // visual changed
-            return;
-        }
+    // A synchronous render redraws the buffer a scheduled slice was converting
+    _cancel_slice();
+    // Cache fast-path: baked loop, shared memory cache, then disk
+    Ref<ImageTexture> cached = _cached_frame(qf_now);
+    if (cached.is_valid()) {
+        texture = cached;
+        last_rendered_qf = qf_now;
+        first_frame_drawn = true;
+        _uploaded_this_frame = true; // visual changed
+        return;
     }
 
     // Set animation frame
@@ -975,45 +1488,185 @@ void LottieAnimation::_render_frame() {
     canvas->sync();
     
     // Copy buffer to image (reuse persistent pixel_bytes to avoid allocations)
+    bool changed = true;
     if (image.is_valid()) {
         const int64_t bytes_needed = (int64_t)render_size.x * (int64_t)render_size.y * 4;
         if (pixel_bytes.size() != bytes_needed) {
             pixel_bytes.resize(bytes_needed);
+            main_tiles.invalidate();
         }
-        // Optimized conversion ARGB -> RGBA into persistent pixel_bytes.
-        _convert_argb_to_rgba_optimized(buffer, pixel_bytes.ptrw(), (size_t)render_size.x * (size_t)render_size.y);
-        if (unpremultiply_alpha) {
-            _unpremultiply_alpha_rgba(pixel_bytes.ptrw(), render_size.x, render_size.y);
-        }
-        if (fix_alpha_border) {
-            _fix_alpha_border_rgba(pixel_bytes.ptrw(), render_size.x, render_size.y);
-        }
-        image->set_data(render_size.x, render_size.y, false, Image::FORMAT_RGBA8, pixel_bytes);
-        if (!texture_ring.empty()) {
-            Ref<ImageTexture> &slot = texture_ring[texture_ring_index];
-            if (slot.is_valid()) {
-                slot->update(image);
-                texture = slot;
-                texture_ring_index = (texture_ring_index + 1) % (int)texture_ring.size();
-            }
-        } else if (texture.is_valid()) {
-            texture->update(image);
-        }
-        // Store in cache if enabled
-        if (frame_cache_enabled && (!cache_only_when_paused || !playing ? true : false)) {
-            int qf = _quantized_frame_index();
-            LottieFrameCache::get_singleton()->put(animation_key, qf, render_size, texture, (size_t)bytes_needed);
+        // Only tiles that changed since the last frame are converted and post-processed.
+        const int dirty_tiles = main_tiles.update(buffer, render_size.x, render_size.y);
+        const bool same_as_shown = dirty_tiles == 0 && texture.is_valid() && texture == main_tiles_texture;
+        if (!same_as_shown) {
+            _convert_dirty_tiles(buffer, pixel_bytes.ptrw(), render_size.x, render_size.y, main_tiles);
         }
+        // Identical pixels are already on screen: skip the upload.
+        changed = !same_as_shown;
+        _commit_main_frame(qf_now, changed);
     }
     last_rendered_qf = qf_now;
-    _uploaded_this_frame = true;
+    if (changed) _uploaded_this_frame = true;
     first_frame_drawn = true;
 }
-int LottieAnimation::_quantized_frame_index() const {
-    if (frame_cache_step <= 1) return (int)std::round(current_frame);
-    int step = std::max(1, frame_cache_step);
-    int idx = (int)std::round(current_frame);
-    return (idx / step) * step;
+
+void LottieAnimation::_commit_main_frame(int qf, bool changed) {
+    const int64_t bytes = (int64_t)render_size.x * (int64_t)render_size.y * 4;
+    if (changed) {
+        image->set_data(render_size.x, render_size.y, false, Image::FORMAT_RGBA8, pixel_bytes);
+        _upload_image_to_ring();
+    }
+    main_tiles_texture = texture;
+    worker_upload_texture.unref();
+    _loop_bake_store(qf, image);
+    if (disk_cache_enabled) {
+        LottieDiskCache::get_singleton()->store(_disk_cache_key(), qf, render_size, pixel_bytes);
+    }
+    // Store in cache if enabled. Ring slots are overwritten later, so the cache gets its own texture.
+    if (frame_cache_enabled && (!cache_only_when_paused || !playing ? true : false)) {
+        uint64_t check = 0;
+        const uint64_t content = lottie_hash_pixels(pixel_bytes.ptr(), (size_t)bytes, &check);
+        LottieFrameCache::get_singleton()->put(_frame_cache_key(), qf, render_size, ImageTexture::create_from_image(image), (size_t)bytes, content, check);
+    }
+}
+
+bool LottieAnimation::_render_slice(const std::chrono::steady_clock::time_point &deadline) {
+    if (!slice_active) {
+        if (!canvas || !animation || !picture || !buffer || !image.is_valid() || rendering) return false;
+        const int qf = _quantized_frame_index();
+        if (first_frame_drawn && !pending_resize && qf == last_rendered_qf) return false;
+        Ref<ImageTexture> cached = _cached_frame(qf);
+        if (cached.is_valid()) {
+            texture = cached;
+            last_rendered_qf = qf;
+            first_frame_drawn = true;
+            _last_drawn_qf = qf;
+            queue_redraw();
+            return false;
+        }
+        animation->frame(current_frame);
+        canvas->update();
+        canvas->draw(false);
+        canvas->sync();
+        const int64_t bytes_needed = (int64_t)render_size.x * (int64_t)render_size.y * 4;
+        if (pixel_bytes.size() != bytes_needed) {
+            pixel_bytes.resize(bytes_needed);
+            main_tiles.invalidate();
+        }
+        const int dirty_tiles = main_tiles.update(buffer, render_size.x, render_size.y);
+        if (dirty_tiles == 0 && texture.is_valid() && texture == main_tiles_texture) {
+            _commit_main_frame(qf, false);
+            last_rendered_qf = qf;
+            first_frame_drawn = true;
+            return false;
+        }
+        slice_active = true;
+        slice_qf = qf;
+        slice_pass = 0;
+        slice_row = 0;
+        if (std::chrono::steady_clock::now() >= deadline) return true;
+    }
+    // Rasterized frame stays in `buffer` between steps; convert whole tile rows until out of time.
+    const int passes = fix_alpha_border ? 2 : 1;
+    while (slice_pass < passes) {
+        _convert_dirty_tile_rows(buffer, pixel_bytes.ptrw(), render_size.x, render_size.y, main_tiles, slice_pass, slice_row, slice_row + 1);
+        if (++slice_row >= main_tiles.tiles_y()) {
+            slice_row = 0;
+            slice_pass++;
+        }
+        if (slice_pass < passes && std::chrono::steady_clock::now() >= deadline) return true;
+    }
+    slice_active = false;
+    _commit_main_frame(slice_qf, true);
+    last_rendered_qf = slice_qf;
+    first_frame_drawn = true;
+    _last_drawn_qf = slice_qf;
+    queue_redraw();
+    return false;
+}
+
+void LottieAnimation::_cancel_slice() {
+    if (!slice_active) return;
+    slice_active = false;
+    // pixel_bytes is only partly converted from the frame main_tiles already remembers
+    main_tiles.invalidate();
+}
+
+int LottieAnimation::_quantized_frame_index() const {
+    return _quantize_frame(current_frame);
+}
+
+int LottieAnimation::_quantize_frame(float frame) const {
+    int idx = (int)std::round(frame);
+    // Frames inside a static run look like its first frame: render, cache and upload that one once.
+    // Segments renumber frames, so hold analysis only applies to the full timeline.
+    if (anim_info && !segment_applied && !frame_stream) idx = anim_info->hold_frame(idx);
+    if (frame_cache_step <= 1) return idx;
+    int step = std::max(1, frame_cache_step);
+    return (idx / step) * step;
+}
+
+Ref<ImageTexture> LottieAnimation::_loop_bake_lookup(int qf) {
+    if (!loop_bake_enabled || !looping || !animation || total_frames <= 0 || render_size.x <= 0 || render_size.y <= 0) {
+        return Ref<ImageTexture>();
+    }
+    if (loop_bake_size != render_size) {
+        // Drop the old capture at once, but only start a new one after the size has held for
+        // the settle time, so a zoom or resize doesn't capture at every intermediate size.
+        if (loop_bake_seen_size != render_size) {
+            _invalidate_loop_bake();
+            loop_bake_seen_size = render_size;
+            loop_bake_seen_at = _elapsed_time;
+            return Ref<ImageTexture>();
+        }
+        if (_elapsed_time - loop_bake_seen_at < (double)std::max(0.2f, progressive_settle_time)) {
+            return Ref<ImageTexture>();
+        }
+        _invalidate_loop_bake();
+        loop_bake_size = render_size;
+        const int step = std::max(1, frame_cache_step);
+        const size_t slots = (size_t)std::ceil(total_frames / (float)step) + 1;
+        const size_t bytes = slots * (size_t)render_size.x * (size_t)render_size.y * 4;
+        if (bytes > (size_t)std::max(1, loop_bake_budget_mb) * 1024ull * 1024ull ||
+                !LottieFrameCache::get_singleton()->reserve_pinned(bytes)) {
+            loop_bake_rejected = true;
+        } else {
+            loop_bake_reserved = bytes;
+            loop_bake_frames.resize(slots);
+            // Static runs share one slot, so count the distinct frames a lap actually visits.
+            int last = -1;
+            for (int f = 0; f < (int)std::ceil(total_frames); f++) {
+                const int qf = _quantize_frame((float)f);
+                if (qf != last) loop_bake_expected++;
+                last = qf;
+            }
+        }
+    }
+    if (loop_bake_rejected) return Ref<ImageTexture>();
+    const int slot = qf / std::max(1, frame_cache_step);
+    if (slot < 0 || slot >= (int)loop_bake_frames.size()) return Ref<ImageTexture>();
+    return loop_bake_frames[slot];
+}
+
+void LottieAnimation::_loop_bake_store(int qf, const Ref<Image> &frame_image) {
+    if (loop_bake_frames.empty() || loop_bake_size != render_size || !frame_image.is_valid()) return;
+    if (frame_image->get_width() != render_size.x || frame_image->get_height() != render_size.y) return;
+    const int slot = qf / std::max(1, frame_cache_step);
+    if (slot < 0 || slot >= (int)loop_bake_frames.size() || loop_bake_frames[slot].is_valid()) return;
+    loop_bake_frames[slot] = ImageTexture::create_from_image(frame_image);
+    loop_bake_filled++;
+}
+
+void LottieAnimation::_invalidate_loop_bake() {
+    if (loop_bake_reserved > 0) {
+        LottieFrameCache::get_singleton()->release_pinned(loop_bake_reserved);
+        loop_bake_reserved = 0;
+    }
+    loop_bake_frames.clear();
+    loop_bake_size = Vector2i();
+    loop_bake_filled = 0;
+    loop_bake_expected = 0;
+    loop_bake_rejected = false;
 }
 
 void LottieAnimation::_ensure_cache_capacity() {
@@ -1030,7 +1683,10 @@ void LottieAnimation::_ready() {
         get_viewport()->connect("size_changed", Callable(this, "_on_viewport_size_changed"));
     }
     // Always load when a path is set; if autoplay is off, render the first frame statically.
-    if (!animation_path.is_empty()) {
+    // A node that starts hidden waits until it is first shown (or played).
+    if (!animation_path.is_empty() && !is_visible_in_tree() && !Engine::get_singleton()->is_editor_hint()) {
+        load_deferred = true;
+    } else if (!animation_path.is_empty()) {
         if (_load_animation(animation_path)) {
             if (autoplay) {
                 play();
@@ -1045,14 +1701,26 @@ void LottieAnimation::_process(double delta) {
     _uploaded_this_frame = false; // reset per-frame flag for redraw gating
     // Coalesce pending resizes safely here, once per frame
     _elapsed_time += delta;
-    if (dynamic_resolution) {
-        _update_resolution_from_scale(); // computes desired and may set pending_resize
-    }
+    if (delta > 0.0) _last_delta = delta;
+    if (!playing && lookahead_active) _clear_lookahead();
     bool applied_resize = false;
-    if (pending_resize && canvas) {
-        // Rate-limit reallocations to avoid thrashing during fast zoom/resize
-        if (_last_resize_at >= 0.0 && (_elapsed_time - _last_resize_at) < (double)_min_resize_interval) {
-            // skip this frame; keep pending_resize true
+    if (!is_visible_in_tree() && !Engine::get_singleton()->is_editor_hint()) {
+        // Hidden long enough: give buffers, textures and the worker back until shown again
+        if (_hidden_since < 0.0) _hidden_since = _elapsed_time;
+        if (release_hidden_after > 0.0f && !resources_released && (canvas || frame_stream) && (_elapsed_time - _hidden_since) >= (double)release_hidden_after) {
+            _release_hidden_resources();
+        }
+    } else {
+        _hidden_since = -1.0;
+        if (resources_released) _ensure_resources();
+    }
+    if (pending_resize && canvas && !frame_stream && !resources_released) {
+        const bool growing = pending_target_size.x > render_size.x || pending_target_size.y > render_size.y;
+        if (progressive_resize && growing && first_frame_drawn && (_elapsed_time - _desired_changed_at) < (double)progressive_settle_time) {
+            // Still zooming in: keep rendering at the current (cheaper) size, scaled up on the GPU,
+            // and refine to full resolution once the scale has settled.
+        } else if (_last_resize_at >= 0.0 && (_elapsed_time - _last_resize_at) < (double)_min_resize_interval) {
+            // Rate-limit reallocations to avoid thrashing during fast zoom/resize; keep pending_resize true
         } else {
             _last_resize_at = _elapsed_time;
             pending_resize = false;
@@ -1063,46 +1731,76 @@ void LottieAnimation::_process(double delta) {
         }
     }
     _update_animation(delta);
+    if (!playing && texture_ring.size() > 1) {
+        _shrink_texture_ring(1); // stopped: give the extra ring slots back to the pool
+    }
+    _poll_prewarm();
+    if (crossfading) {
+        _render_crossfade_source(delta);
+    }
     if (is_visible_in_tree() || Engine::get_singleton()->is_editor_hint()) {
         // Culling disabled: always treat as visible and post/refresh on frame/size change
         bool on_screen_now = true;
         bool became_visible = false;
-        if (render_thread_enabled) {
-            // Ask worker to render the next desired frame
+        if (frame_stream) {
+            // Pre-rendered stream: decode on the main thread, no rasterization
+            if (!first_frame_drawn || _quantized_frame_index() != last_rendered_qf) {
+                _render_stream_frame();
+            }
+        } else if (render_thread_enabled) {
+            // Ask worker to render the next desired frame, unless the cache already holds it
             {
                 int qf = _quantized_frame_index();
                 if (render_size != last_posted_size || qf != last_posted_qf) {
-                    _post_render_to_worker(render_size, current_frame);
+                    Ref<ImageTexture> cached = _cached_frame(qf);
+                    if (cached.is_valid()) {
+                        {
+                            std::lock_guard<std::mutex> lk(job_mutex);
+                            render_pending = false;
+                        }
+                        {
+                            // Drop any older frame still in flight so it can't replace the cached one
+                            std::lock_guard<std::mutex> lk(frame_mutex);
+                            latest_frame.ready = false;
+                            last_consumed_id = next_frame_id;
+                        }
+                        texture = cached;
+                        last_rendered_qf = qf;
+                        _uploaded_this_frame = true;
+                    } else if (_take_lookahead_frame(qf)) {
+                        // Rendered ahead of time: shown this tick, nothing to post
+                        {
+                            std::lock_guard<std::mutex> lk(job_mutex);
+                            render_pending = false;
+                        }
+                        std::lock_guard<std::mutex> lk(frame_mutex);
+                        latest_frame.ready = false;
+                        last_consumed_id = next_frame_id;
+                    } else {
+                        _post_render_to_worker(render_size, current_frame);
+                        // Show this frame from another size class, scaled, until the exact size arrives
+                        Ref<ImageTexture> nearest = _cached_frame_nearest(qf);
+                        if (nearest.is_valid() && nearest != texture) {
+                            texture = nearest;
+                            _uploaded_this_frame = true;
+                        }
+                    }
                     last_posted_size = render_size;
                     last_posted_qf = qf;
+                    _post_lookahead(qf);
                 }
             }
             // Try to upload the most recent finished frame
             {
                 std::lock_guard<std::mutex> lk(frame_mutex);
                 if (latest_frame.ready && latest_frame.id > last_consumed_id) {
-                    if (latest_frame.w == render_size.x && latest_frame.h == render_size.y) {
-                        // Ensure image/texture prepared for this size
-                        if (!image.is_valid() || image->get_width() != render_size.x || image->get_height() != render_size.y) {
-                            _create_texture();
-                        }
-                        PackedByteArray pba;
-                        pba.resize((int64_t)latest_frame.rgba.size());
-                        {
-                            uint8_t *dst = pba.ptrw();
-                            memcpy(dst, latest_frame.rgba.data(), latest_frame.rgba.size());
-                        }
-                        image->set_data(render_size.x, render_size.y, false, Image::FORMAT_RGBA8, pba);
-                        if (!texture_ring.empty()) {
-                            Ref<ImageTexture> &slot = texture_ring[texture_ring_index];
-                            if (slot.is_valid()) {
-                                slot->update(image);
-                                texture = slot;
-                                texture_ring_index = (texture_ring_index + 1) % (int)texture_ring.size();
-                            }
-                        } else if (texture.is_valid()) {
-                            texture->update(image);
-                        }
+                    if (latest_frame.unchanged && texture.is_valid() && texture == worker_upload_texture) {
+                        // No tile changed since the frame on screen: nothing to upload
+                        last_consumed_id = latest_frame.id;
+                        latest_frame.ready = false;
+                    } else if (latest_frame.w == render_size.x && latest_frame.h == render_size.y) {
+                        _upload_worker_rgba(latest_frame.rgba, latest_frame.frame);
+                        worker_upload_texture = texture;
                         last_consumed_id = latest_frame.id;
                         latest_frame.ready = false;
                         _uploaded_this_frame = true; // visual changed
@@ -1115,8 +1813,12 @@ void LottieAnimation::_process(double delta) {
         } else {
             // Only render on main thread if frame or size changed
             int qf = _quantized_frame_index();
-            if (pending_resize || !first_frame_drawn || qf != last_rendered_qf) {
-                _render_frame();
+            if (slice_active || pending_resize || !first_frame_drawn || qf != last_rendered_qf) {
+                if (LottieRenderScheduler::get_singleton()->get_budget_usec() > 0) {
+                    LottieRenderScheduler::get_singleton()->request(this); // rendered next frame, within budget
+                } else {
+                    _render_frame();
+                }
             }
         }
     }
@@ -1125,29 +1827,599 @@ void LottieAnimation::_process(double delta) {
         queue_redraw();
         _last_drawn_qf = last_rendered_qf;
     }
+    if (_can_sleep()) {
+        set_process(false); // woken by play/seek/load/transform/visibility changes
+    }
+}
+
+void LottieAnimation::_upload_worker_rgba(const std::vector<uint8_t> &rgba, float frame) {
+    // Ensure image/texture prepared for this size
+    if (!image.is_valid() || image->get_width() != render_size.x || image->get_height() != render_size.y) {
+        _create_texture();
+    }
+    PackedByteArray pba;
+    pba.resize((int64_t)rgba.size());
+    memcpy(pba.ptrw(), rgba.data(), rgba.size());
+    image->set_data(render_size.x, render_size.y, false, Image::FORMAT_RGBA8, pba);
+    _upload_image_to_ring();
+    main_tiles_texture.unref();
+    const int uploaded_qf = _quantize_frame(frame);
+    _loop_bake_store(uploaded_qf, image);
+    if (disk_cache_enabled) {
+        LottieDiskCache::get_singleton()->store(_disk_cache_key(), uploaded_qf, render_size, pba);
+    }
+}
+
+bool LottieAnimation::_take_lookahead_frame(int qf) {
+    if (!lookahead_active) return false;
+    FrameResult hit;
+    {
+        std::lock_guard<std::mutex> lk(frame_mutex);
+        for (auto it = ahead_results.begin(); it != ahead_results.end(); ++it) {
+            if (it->w == render_size.x && it->h == render_size.y && _quantize_frame(it->frame) == qf) {
+                hit = std::move(*it);
+                ahead_results.erase(it);
+                break;
+            }
+        }
+    }
+    if (hit.rgba.empty()) return false;
+    _upload_worker_rgba(hit.rgba, hit.frame);
+    // The worker diffs against its own last frame, which may not be this one
+    worker_upload_texture.unref();
+    last_rendered_qf = qf;
+    _uploaded_this_frame = true;
+    return true;
+}
+
+void LottieAnimation::_post_lookahead(int qf) {
+    if (!playing || lookahead_frames <= 0 || total_frames <= 0.0f || duration <= 0.0f || frame_stream) return;
+    // Frames the next ticks will ask for, assuming the tick rate and speed hold.
+    const float step = (total_frames / duration) * speed * (float)_last_delta;
+    if (step <= 0.0f) return;
+    std::vector<int> want_qf;
+    std::vector<float> want_frame;
+    float f = current_frame;
+    for (int k = 0; k < lookahead_frames * 8 && (int)want_qf.size() < lookahead_frames; k++) {
+        f += step;
+        if (f >= total_frames) {
+            if (!looping) break;
+            f = std::fmod(f, total_frames);
+        }
+        const int q = _quantize_frame(f);
+        if (q == qf || std::find(want_qf.begin(), want_qf.end(), q) != want_qf.end()) continue;
+        want_qf.push_back(q);
+        want_frame.push_back(f);
+    }
+    std::vector<int> have_qf;
+    {
+        // Drop results the playhead will not reach
+        std::lock_guard<std::mutex> lk(frame_mutex);
+        for (auto it = ahead_results.begin(); it != ahead_results.end();) {
+            const int q = _quantize_frame(it->frame);
+            const bool keep = it->w == render_size.x && it->h == render_size.y && std::find(want_qf.begin(), want_qf.end(), q) != want_qf.end();
+            if (keep) {
+                have_qf.push_back(q);
+                ++it;
+            } else {
+                it = ahead_results.erase(it);
+            }
+        }
+    }
+    // Filter against the caches before locking; the worker waits on job_mutex between frames.
+    std::vector<size_t> todo;
+    for (size_t i = 0; i < want_qf.size(); i++) {
+        if (std::find(have_qf.begin(), have_qf.end(), want_qf[i]) != have_qf.end()) continue;
+        if (_loop_bake_lookup(want_qf[i]).is_valid()) continue;
+        if (_cache_lookup_allowed() && LottieFrameCache::get_singleton()->get(_frame_cache_key(), want_qf[i], render_size).is_valid()) continue;
+        todo.push_back(i);
+    }
+    lookahead_active = true;
+    std::lock_guard<std::mutex> lk(job_mutex);
+    pending_ahead.clear(); // last request wins, like the current frame
+    const int inflight_qf = ahead_inflight ? _quantize_frame(ahead_inflight_frame) : -1;
+    for (size_t i : todo) {
+        if (want_qf[i] == inflight_qf) continue;
+        pending_ahead.push_back(AheadJob{render_size, want_frame[i], ahead_generation});
+    }
+    if (!pending_ahead.empty()) job_cv.notify_one();
+}
+
+void LottieAnimation::_clear_lookahead() {
+    {
+        std::lock_guard<std::mutex> lk(job_mutex);
+        pending_ahead.clear();
+        ahead_generation++;
+    }
+    {
+        std::lock_guard<std::mutex> lk(frame_mutex);
+        ahead_results.clear();
+    }
+    lookahead_active = false;
+}
+
+void LottieAnimation::_wake() {
+    if (is_inside_tree() && !is_processing()) set_process(true);
+}
+
+bool LottieAnimation::_can_sleep() {
+    // Inspector edits reach the node through many setters; keep polling in the editor.
+    if (Engine::get_singleton()->is_editor_hint()) return false;
+    if (playing || crossfading || prewarm_active || !prewarm_queue.empty()) return false;
+    if (pending_resize && !resources_released) return false;
+    const bool visible = is_visible_in_tree();
+    if (!visible) {
+        // Stay awake only while the hidden-release timer runs
+        return release_hidden_after <= 0.0f || resources_released || (!canvas && !frame_stream);
+    }
+    if (!animation && !frame_stream) return true;
+    const int qf = _quantized_frame_index();
+    if (frame_stream || !render_thread_enabled) return first_frame_drawn && qf == last_rendered_qf && !slice_queued && !slice_active;
+    if (qf != last_posted_qf || render_size != last_posted_size) return false;
+    {
+        std::lock_guard<std::mutex> lk(job_mutex);
+        if (load_pending || render_pending || segment_pending || worker_rendering) return false;
+    }
+    std::lock_guard<std::mutex> lk(frame_mutex);
+    return !(latest_frame.ready && latest_frame.id > last_consumed_id);
+}
+
+Rect2 LottieAnimation::_display_rect() const {
+    // Draw at logical display size (fit_box_size), independent of internal render resolution.
+    // Apply offset so Node2D position can serve as YSort pivot (e.g. feet) while image draws above it.
+    Vector2 size = Vector2((float)fit_box_size.x, (float)fit_box_size.y);
+    Vector2 half_box = size * 0.5f;
+    // top_left = -half_box means centered; adding offset shifts the drawing
+    return Rect2(-half_box + offset, size);
 }
 
 void LottieAnimation::_draw() {
+    if (crossfading && _draw_crossfade()) {
+        return;
+    }
+    if (crossfade_item.is_valid()) {
+        RenderingServer::get_singleton()->canvas_item_clear(crossfade_item);
+    }
     if (texture.is_valid()) {
-        // Draw at logical display size (fit_box_size), independent of internal render resolution.
-        // Apply offset so Node2D position can serve as YSort pivot (e.g. feet) while image draws above it.
-        Vector2 size = Vector2((float)fit_box_size.x, (float)fit_box_size.y);
-        Vector2 half_box = size * 0.5f;
-        // top_left = -half_box means centered; adding offset shifts the drawing
-        Rect2 dst = Rect2(-half_box + offset, size);
-        Rect2 src = Rect2(Vector2(0, 0), Vector2((float)render_size.x, (float)render_size.y));
-        draw_texture_rect_region(texture, dst, src);
+        // The texture may come from another size class than render_size; draw all of it.
+        Rect2 src = Rect2(Vector2(0, 0), texture->get_size());
+        draw_texture_rect_region(texture, _display_rect(), src);
+    }
+}
+
+static Ref<Shader> g_crossfade_shader;
+
+static const char *CROSSFADE_SHADER_CODE = R"(
+shader_type canvas_item;
+
+uniform sampler2D from_tex : filter_linear;
+uniform float blend = 0.0;
+
+varying vec4 tint;
+
+void vertex() {
+    tint = COLOR;
+}
+
+void fragment() {
+    vec4 to_color = texture(TEXTURE, UV);
+    vec4 from_color = texture(from_tex, UV);
+    COLOR = mix(from_color, to_color, clamp(blend, 0.0, 1.0)) * tint;
+}
+)";
+
+bool LottieAnimation::_draw_crossfade() {
+    if (texture.is_null() || crossfade_from.texture.is_null()) return false;
+    RenderingServer *rs = RenderingServer::get_singleton();
+    if (crossfade_material.is_null()) {
+        if (g_crossfade_shader.is_null()) {
+            g_crossfade_shader.instantiate();
+            g_crossfade_shader->set_code(CROSSFADE_SHADER_CODE);
+        }
+        crossfade_material.instantiate();
+        crossfade_material->set_shader(g_crossfade_shader);
+    }
+    if (!crossfade_item.is_valid()) {
+        // Child canvas item so the blend material does not replace the node's own material.
+        crossfade_item = rs->canvas_item_create();
+        rs->canvas_item_set_parent(crossfade_item, get_canvas_item());
+        rs->canvas_item_set_material(crossfade_item, crossfade_material->get_rid());
+    }
+    crossfade_material->set_shader_parameter("from_tex", crossfade_from.texture);
+    crossfade_material->set_shader_parameter("blend", crossfade_progress);
+    rs->canvas_item_clear(crossfade_item);
+    // Both textures are sampled with the same UVs, so they may differ in resolution.
+    Rect2 src = Rect2(Vector2(0, 0), texture->get_size());
+    rs->canvas_item_add_texture_rect_region(crossfade_item, _display_rect(), texture->get_rid(), src);
+    return true;
+}
+
+void LottieAnimation::crossfade_to(const String &path) {
+    _wake();
+    if (path.is_empty() || path == animation_path) return;
+    if (crossfading) finish_crossfade();
+    if (!canvas || !animation || !picture || texture.is_null() || !is_inside_tree()) {
+        set_animation_path(path);
+        return;
+    }
+    // Hand the current main-thread canvas to the outgoing slot; it keeps its picture and buffer.
+    crossfade_from.canvas = canvas;
+    crossfade_from.animation = animation;
+    crossfade_from.buffer = buffer;
+    crossfade_from.size = render_size;
+    crossfade_from.frame = current_frame;
+    crossfade_from.total_frames = total_frames;
+    crossfade_from.duration = duration;
+    crossfade_from.speed = speed;
+    crossfade_from.looping = looping;
+    crossfade_from.last_qf = (int)std::round(current_frame);
+    crossfade_from.path = animation_path;
+    crossfade_from.abs_path = loaded_abs_path;
+    crossfade_from.key = animation_key;
+    crossfade_from.base_size = base_picture_size;
+    crossfade_from.segment_applied = segment_applied;
+    crossfade_from.segment_key = segment_key;
+    crossfade_from.texture = texture; // last shown frame until the first outgoing re-render
+    crossfade_from.image.unref();
+    crossfade_from.pixels = PackedByteArray();
+    crossfading = true;
+    crossfade_progress = 0.0f;
+
+    tvg::EngineOption render_opt = tvg::EngineOption::Default;
+    if (engine_option == 1) render_opt = tvg::EngineOption::SmartRender;
+    canvas = tvg::SwCanvas::gen(render_opt);
+    animation = nullptr;
+    picture = nullptr;
+    buffer = nullptr;
+    if (!canvas) {
+        UtilityFunctions::printerr("Failed to create ThorVG canvas");
+        _restore_crossfade_source();
+        return;
+    }
+    first_frame_drawn = false;
+    last_rendered_qf = -1;
+    last_posted_qf = -1;
+    if (!_apply_animation_path(path)) {
+        _restore_crossfade_source();
+    }
+    queue_redraw();
+}
+
+void LottieAnimation::_render_crossfade_source(double delta) {
+    CrossfadeSource &src = crossfade_from;
+    if (!src.canvas || !src.animation || !src.buffer || src.total_frames <= 0 || src.duration <= 0) return;
+    src.frame += (src.total_frames / src.duration) * (float)delta * src.speed;
+    if (src.frame >= src.total_frames) {
+        src.frame = src.looping ? fmod(src.frame, src.total_frames) : src.total_frames - 1;
+    }
+    if (src.task >= 0) {
+        WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+        if (!pool->is_task_completed(src.task)) return; // keep showing the previous outgoing frame
+        pool->wait_for_task_completion(src.task);
+        src.task = -1;
+        _upload_crossfade_source();
+    }
+    int qf = (int)std::round(src.frame);
+    if (qf == src.last_qf) return;
+    src.last_qf = qf;
+    src.task_frame = src.frame;
+    if (render_thread_enabled) {
+        src.task = WorkerThreadPool::get_singleton()->add_task(callable_mp(this, &LottieAnimation::_crossfade_render_task), false, "Lottie crossfade");
+    } else {
+        _crossfade_render_task();
+        _upload_crossfade_source();
+    }
+}
+
+void LottieAnimation::_crossfade_render_task() {
+    CrossfadeSource &src = crossfade_from;
+    src.animation->frame(src.task_frame);
+    src.canvas->update();
+    src.canvas->draw(false);
+    src.canvas->sync();
+    src.rgba.resize((size_t)src.size.x * (size_t)src.size.y * 4);
+    lottie_convert_argb_to_rgba(src.buffer, src.rgba.data(), (size_t)src.size.x * (size_t)src.size.y);
+    if (unpremultiply_alpha) {
+        _unpremultiply_alpha_rgba(src.rgba.data(), src.size.x, src.size.y);
+    }
+    if (fix_alpha_border) {
+        _fix_alpha_border_rgba(src.rgba.data(), src.size.x, src.size.y);
+    }
+}
+
+void LottieAnimation::_upload_crossfade_source() {
+    CrossfadeSource &src = crossfade_from;
+    if (src.rgba.empty()) return;
+    if (src.pixels.size() != (int64_t)src.rgba.size()) src.pixels.resize((int64_t)src.rgba.size());
+    memcpy(src.pixels.ptrw(), src.rgba.data(), src.rgba.size());
+    if (src.image.is_null()) {
+        // Own texture: the previous one belongs to the incoming ring or the frame cache.
+        src.image = Image::create_from_data(src.size.x, src.size.y, false, Image::FORMAT_RGBA8, src.pixels);
+        src.texture = ImageTexture::create_from_image(src.image);
+    } else {
+        src.image->set_data(src.size.x, src.size.y, false, Image::FORMAT_RGBA8, src.pixels);
+        src.texture->update(src.image);
+    }
+    _uploaded_this_frame = true;
+}
+
+void LottieAnimation::_release_crossfade_source() {
+    CrossfadeSource &src = crossfade_from;
+    if (src.task >= 0) WorkerThreadPool::get_singleton()->wait_for_task_completion(src.task);
+    if (src.canvas) {
+        src.canvas->remove();
+        delete src.canvas;
+    }
+    // Back to the bundle pool when resident, freed otherwise.
+    if (src.animation) LottieResidentPool::get_singleton()->give(std::string(src.abs_path.utf8().get_data()), src.animation, src.total_frames);
+    if (src.buffer) LottieBufferPool::get_singleton()->release_pixels(src.buffer, src.size);
+    src = CrossfadeSource();
+    crossfading = false;
+    crossfade_progress = 0.0f;
+}
+
+void LottieAnimation::_restore_crossfade_source() {
+    CrossfadeSource &src = crossfade_from;
+    if (src.task >= 0) WorkerThreadPool::get_singleton()->wait_for_task_completion(src.task);
+    // Drop whatever the failed load left on the new canvas, then take the outgoing one back.
+    if (picture && canvas) canvas->remove();
+    delete animation;
+    delete canvas;
+    if (buffer) LottieBufferPool::get_singleton()->release_pixels(buffer, render_size);
+    canvas = src.canvas;
+    animation = src.animation;
+    picture = animation->picture();
+    buffer = src.buffer;
+    render_size = src.size;
+    total_frames = src.total_frames;
+    duration = src.duration;
+    current_frame = src.frame;
+    base_picture_size = src.base_size;
+    segment_applied = src.segment_applied;
+    segment_key = src.segment_key;
+    loaded_abs_path = src.abs_path;
+    animation_path = src.path;
+    if (animation_key != src.key) {
+        if (!animation_key.is_empty()) _registry_dec(animation_key);
+        animation_key = src.key;
+        _registry_inc(animation_key);
+    }
+    anim_info = LottieAnimationIndex::get_singleton()->get_info(animation_key);
+    _recompute_live_cache_state();
+    _update_resident_bundle(animation_path);
+    disk_cache_key = String();
+    _invalidate_loop_bake();
+    if (image.is_null() || image->get_width() != render_size.x || image->get_height() != render_size.y) _create_texture();
+    texture = src.texture; // keep showing the last outgoing frame until the next render
+    first_frame_drawn = false;
+    last_rendered_qf = -1;
+    last_posted_qf = -1;
+    src = CrossfadeSource();
+    crossfading = false;
+    crossfade_progress = 0.0f;
+}
+
+void LottieAnimation::set_crossfade_progress(float p_progress) {
+    _wake();
+    crossfade_progress = std::clamp(p_progress, 0.0f, 1.0f);
+    if (crossfading && crossfade_material.is_valid()) {
+        crossfade_material->set_shader_parameter("blend", crossfade_progress);
+    }
+}
+
+float LottieAnimation::get_crossfade_progress() const {
+    return crossfade_progress;
+}
+
+void LottieAnimation::finish_crossfade() {
+    if (!crossfading) return;
+    // Outgoing rendering stops here; its canvas, buffer and texture are released.
+    _release_crossfade_source();
+    if (crossfade_item.is_valid()) {
+        RenderingServer::get_singleton()->canvas_item_clear(crossfade_item);
+    }
+    queue_redraw();
+}
+
+bool LottieAnimation::is_crossfading() const {
+    return crossfading;
+}
+
+bool LottieAnimation::start_state_machine(const String &machine) {
+    String name = machine.is_empty() ? active_state_machine : machine;
+    if (!sm_machine_sources.has(name)) {
+        UtilityFunctions::printerr("State machine not found in .lottie: " + name);
+        return false;
+    }
+    if (!dotlottie_sm.load((String)sm_machine_sources[name])) {
+        return false;
+    }
+    active_state_machine = name;
+    dotlottie_sm_pointer_inside = false;
+    dotlottie_sm_hovered_layers.clear();
+    dotlottie_sm.start();
+    _apply_dotlottie_sm_events();
+    return true;
+}
+
+void LottieAnimation::stop_state_machine() {
+    dotlottie_sm.stop();
+}
+
+bool LottieAnimation::is_state_machine_running() const {
+    return dotlottie_sm.is_running();
+}
+
+String LottieAnimation::get_state_machine_state() const {
+    const LottieDotLottieStateMachine::State *st = dotlottie_sm.get_state(dotlottie_sm.get_current_state());
+    return st ? st->name : String();
+}
+
+bool LottieAnimation::set_state_machine_input(const String &name, const Variant &value) {
+    bool found = dotlottie_sm.set_input(name, value);
+    _apply_dotlottie_sm_events();
+    return found;
+}
+
+Variant LottieAnimation::get_state_machine_input(const String &name) const {
+    return dotlottie_sm.get_input(name);
+}
+
+void LottieAnimation::fire_state_machine_event(const String &name) {
+    dotlottie_sm.fire(name);
+    _apply_dotlottie_sm_events();
+}
+
+void LottieAnimation::post_state_machine_pointer(const String &type, const Vector2 &position) {
+    using SM = LottieDotLottieStateMachine;
+    if (!dotlottie_sm.is_running()) return;
+    SM::InteractionType kind = SM::interaction_type_from_string(type);
+    if (kind == SM::INTERACTION_INVALID || kind == SM::INTERACTION_ON_COMPLETE || kind == SM::INTERACTION_ON_LOOP_COMPLETE) {
+        UtilityFunctions::printerr("Unknown pointer event: " + type);
+        return;
+    }
+    const Rect2 rect = _display_rect();
+    const bool inside = rect.has_point(position);
+    std::vector<String> hit;
+    if (inside && canvas && animation && picture && rect.size.x > 0 && rect.size.y > 0) {
+        Vector2 rel = (position - rect.position) / rect.size;
+        Vector2 buffer_pos(rel.x * (float)render_size.x, rel.y * (float)render_size.y);
+        // Layer bounds must match the displayed frame; the worker renders from its own copy.
+        animation->frame(current_frame);
+        canvas->update();
+        for (const SM::Interaction &it : dotlottie_sm.get_interactions()) {
+            if (it.layer.is_empty() || std::find(hit.begin(), hit.end(), it.layer) != hit.end()) continue;
+            if (_hit_test_layer(it.layer, buffer_pos)) hit.push_back(it.layer);
+        }
+    }
+
+    if (kind == SM::INTERACTION_POINTER_MOVE || kind == SM::INTERACTION_POINTER_ENTER || kind == SM::INTERACTION_POINTER_EXIT) {
+        // Enter/exit are derived from movement, so callers only forward motion.
+        std::vector<String> entered, exited;
+        for (const String &l : hit) {
+            if (std::find(dotlottie_sm_hovered_layers.begin(), dotlottie_sm_hovered_layers.end(), l) == dotlottie_sm_hovered_layers.end()) entered.push_back(l);
+        }
+        for (const String &l : dotlottie_sm_hovered_layers) {
+            if (std::find(hit.begin(), hit.end(), l) == hit.end()) exited.push_back(l);
+        }
+        const bool node_entered = inside && !dotlottie_sm_pointer_inside;
+        const bool node_exited = !inside && dotlottie_sm_pointer_inside;
+        dotlottie_sm_hovered_layers = hit;
+        dotlottie_sm_pointer_inside = inside;
+        if (!exited.empty() || node_exited) dotlottie_sm.post_interaction(SM::INTERACTION_POINTER_EXIT, exited, node_exited);
+        if (!entered.empty() || node_entered) dotlottie_sm.post_interaction(SM::INTERACTION_POINTER_ENTER, entered, node_entered);
+        dotlottie_sm.post_interaction(SM::INTERACTION_POINTER_MOVE, hit, inside);
+    } else {
+        dotlottie_sm.post_interaction(kind, hit, inside);
+        if (kind == SM::INTERACTION_POINTER_UP) dotlottie_sm.post_interaction(SM::INTERACTION_CLICK, hit, inside);
+    }
+    _apply_dotlottie_sm_events();
+}
+
+bool LottieAnimation::_hit_test_layer(const String &layer, const Vector2 &buffer_pos) const {
+    if (!picture) return false;
+    // Lottie layers are addressable by the hash of their name.
+    const tvg::Paint *paint = picture->paint(tvg::Accessor::id(layer.utf8().get_data()));
+    if (!paint) return false;
+    return const_cast<tvg::Paint *>(paint)->intersects((int32_t)buffer_pos.x, (int32_t)buffer_pos.y, 1, 1);
+}
+
+void LottieAnimation::_post_dotlottie_sm_interaction(LottieDotLottieStateMachine::InteractionType type) {
+    if (!dotlottie_sm.is_running()) return;
+    dotlottie_sm.post_interaction(type, std::vector<String>(), true);
+    _apply_dotlottie_sm_events();
+}
+
+void LottieAnimation::_apply_dotlottie_sm_events() {
+    using SM = LottieDotLottieStateMachine;
+    std::vector<SM::Event> events;
+    dotlottie_sm.take_events(events);
+    for (const SM::Event &e : events) {
+        const SM::State *st = dotlottie_sm.get_state(e.state);
+        switch (e.type) {
+            case SM::EVENT_STATE_EXITED:
+                if (st) emit_signal("state_machine_state_exited", st->name);
+                break;
+            case SM::EVENT_STATE_ENTERED:
+                if (st) {
+                    _enter_dotlottie_sm_state(*st);
+                    emit_signal("state_machine_state_entered", st->name);
+                }
+                break;
+            case SM::EVENT_SET_FRAME:
+                set_frame(e.value);
+                break;
+            case SM::EVENT_SET_PROGRESS:
+                set_frame(total_frames * CLAMP(e.value, 0.0f, 100.0f) / 100.0f);
+                break;
+            case SM::EVENT_CUSTOM:
+                emit_signal("state_machine_custom_event", e.text);
+                break;
+        }
     }
 }
 
+void LottieAnimation::_enter_dotlottie_sm_state(const LottieDotLottieStateMachine::State &state) {
+    if (state.global) return;
+    if (!state.animation.is_empty() && state.animation != active_animation_id && sm_anim_inner_paths.has(state.animation)) {
+        active_animation_id = state.animation;
+        selected_dotlottie_animation = state.animation;
+        if (!_load_animation(animation_path)) return;
+    }
+    if (!animation) return;
+    float sb = 0.0f, se = total_frames;
+    if (state.segment.is_empty() || !_find_marker_range(state.segment, sb, se)) {
+        sb = 0.0f;
+        se = total_frames;
+    }
+    _apply_segment(sb, se);
+    looping = state.loop;
+    speed = state.speed;
+    current_frame = 0.0f;
+    if (state.autoplay) {
+        play();
+    } else {
+        pause();
+        set_frame(0.0f);
+    }
+}
+
+void LottieAnimation::release_shared_resources() {
+    g_crossfade_shader.unref();
+    g_dotlottie_bundles.clear();
+    g_clock_groups.clear();
+}
+
 void LottieAnimation::_notification(int32_t p_what) {
     switch (p_what) {
+        case NOTIFICATION_ENTER_TREE:
+            _update_resolution_registration();
+            _wake(); // changes made while out of the tree could not wake the node
+            break;
+        case NOTIFICATION_EXIT_TREE:
+            LottieRenderScheduler::get_singleton()->cancel(this);
+            if (resolution_registered) {
+                LottieResolutionManager::get_singleton()->unregister_node(this);
+                resolution_registered = false;
+            }
+            break;
         case NOTIFICATION_TRANSFORM_CHANGED:
         case NOTIFICATION_LOCAL_TRANSFORM_CHANGED:
         case NOTIFICATION_WORLD_2D_CHANGED:
             if (dynamic_resolution) {
+                _refresh_node_scale();
                 _update_resolution_from_scale(); // sets pending resize; actual apply happens in _process
                 // redraw will be queued in _process when resize applies or a new frame uploads
+                if (pending_resize) _wake();
+            }
+            break;
+        case NOTIFICATION_VISIBILITY_CHANGED:
+            _wake();
+            if (is_visible_in_tree()) {
+                _load_deferred();
+                if (resources_released) _ensure_resources();
+            } else {
+                _hidden_since = _elapsed_time;
             }
             break;
         default:
@@ -1157,33 +2429,26 @@ void LottieAnimation::_notification(int32_t p_what) {
 
 void LottieAnimation::_allocate_buffer_and_target(const Vector2i &size) {
     if (size.x <= 0 || size.y <= 0) return;
+    // Same target size: keep the buffer (resident swaps and reloads reuse it as-is).
+    if (buffer && Vector2i(std::min(size.x, max_render_size.x), std::min(size.y, max_render_size.y)) == render_size) return;
     Ref<ImageTexture> old_texture = texture;
-    Ref<Image> old_image = image;
     Vector2i old_render_size = render_size;
 
-    if (buffer) { delete[] buffer; buffer = nullptr; }
+    if (lookahead_active) _clear_lookahead();
+    _cancel_slice();
+    // Recycle through the shared pool: zooming walks back and forth over the same few sizes.
+    if (buffer) { LottieBufferPool::get_singleton()->release_pixels(buffer, render_size); buffer = nullptr; }
     render_size = Vector2i(std::min(size.x, max_render_size.x), std::min(size.y, max_render_size.y));
-    buffer = new uint32_t[(size_t)render_size.x * (size_t)render_size.y];
-    memset(buffer, 0, (size_t)render_size.x * (size_t)render_size.y * sizeof(uint32_t));
+    buffer = LottieBufferPool::get_singleton()->acquire_pixels(render_size);
     canvas->target(buffer, render_size.x, render_size.x, render_size.y, tvg::ColorSpace::ARGB8888S);
     pixel_bytes.resize((int64_t)render_size.x * (int64_t)render_size.y * 4);
+    main_tiles.invalidate();
     _create_texture();
 
-    // If we had an old texture and sizes differ, scale old image into new one as a placeholder (avoids flash)
-    if (old_image.is_valid() && image.is_valid() && (old_render_size != render_size)) {
-        Ref<Image> temp = old_image->duplicate();
-        if (temp.is_valid()) {
-            temp->resize(render_size.x, render_size.y, Image::INTERPOLATE_BILINEAR);
-            if (!texture_ring.empty()) {
-                Ref<ImageTexture> &slot = texture_ring[0];
-                if (slot.is_valid()) {
-                    slot->update(temp);
-                    texture = slot; // use scaled previous content until new frame arrives
-                }
-            } else if (texture.is_valid()) {
-                texture->update(temp);
-            }
-        }
+    // Keep drawing the previous texture until a frame at the new size arrives (avoids flash).
+    // _draw samples the whole texture, so the GPU scales it; no CPU resize of the old image.
+    if (old_texture.is_valid() && old_render_size != render_size) {
+        texture = old_texture;
     }
 }
 
@@ -1194,17 +2459,7 @@ void LottieAnimation::_apply_sizing_policy() {
 
 void LottieAnimation::_apply_picture_transform_to_fit() {
     if (!picture) return;
-    float pw = std::max(1.0f, (float)base_picture_size.x);
-    float ph = std::max(1.0f, (float)base_picture_size.y);
-    float sx = (float)render_size.x / pw;
-    float sy = (float)render_size.y / ph;
-    float s = std::min(sx, sy);
-    // Compose absolute transform matrix to avoid cumulative state
-    tvg::Matrix m;
-    m.e11 = s;   m.e12 = 0.0f; m.e13 = (render_size.x - pw * s) * 0.5f; // tx
-    m.e21 = 0.0f; m.e22 = s;   m.e23 = (render_size.y - ph * s) * 0.5f; // ty
-    m.e31 = 0.0f; m.e32 = 0.0f; m.e33 = 1.0f;
-    picture->transform(m);
+    fit_picture(picture, base_picture_size, render_size);
 }
 
 String LottieAnimation::_current_state_segment_marker() const {
@@ -1218,70 +2473,48 @@ String LottieAnimation::_current_state_segment_marker() const {
     return active_state;
 }
 
-bool LottieAnimation::_find_marker_range(const String &json_path, const String &marker, float &out_begin, float &out_end) const {
+bool LottieAnimation::_find_marker_range(const String &marker, float &out_begin, float &out_end) const {
     out_begin = 0.0f; out_end = 0.0f;
-    if (json_path.is_empty() || marker.is_empty()) return false;
-    String abs = ProjectSettings::get_singleton()->globalize_path(json_path);
-    Ref<FileAccess> f = FileAccess::open(abs, FileAccess::READ);
-    if (f.is_null()) return false;
-    PackedByteArray data = f->get_buffer(f->get_length());
-    f->close();
-    String text = data.get_string_from_utf8();
-    Variant v = JSON::parse_string(text);
-    if (v.get_type() != Variant::DICTIONARY) return false;
-    Dictionary d = v;
-    // fr: frame rate; ip/op: in/out points in frames. Markers are in frames as well in many exports.
-    double fr = d.has("fr") ? (double)d["fr"] : 60.0;
-    if (!d.has("markers")) return false;
-    Array markers = d["markers"];
-    for (int i = 0; i < markers.size(); i++) {
-        if (markers[i].get_type() != Variant::DICTIONARY) continue;
-        Dictionary mk = markers[i];
-        String name;
-        if (mk.has("cm")) name = (String)mk["cm"]; // common in Bodymovin
-        else if (mk.has("n")) name = (String)mk["n"]; // alternative key
-        if (name != marker) continue;
-        double tm = 0.0; double dr = 0.0;
-        if (mk.has("tm")) tm = (double)mk["tm"]; // start frame/time
-        if (mk.has("dr")) dr = (double)mk["dr"]; // duration in frames
-        // Some exports may use seconds, but most use frames. We'll assume frames; if total_frames looks small, this still maps.
-        out_begin = (float)tm;
-        out_end = (float)(tm + dr);
-        if (out_end <= out_begin) out_end = out_begin + 1.0f;
-        return true;
-    }
-    return false;
+    if (!anim_info) return false;
+    return anim_info->find_marker(marker, out_begin, out_end);
 }
 
 void LottieAnimation::_apply_selected_state_segment() {
     String marker = _current_state_segment_marker();
-    if (marker.is_empty()) return;
-    // Try to resolve marker to frame range from the loaded JSON and apply range segment
+    // Try to resolve marker to frame range from the loaded JSON and apply range segment;
+    // a state without one plays the full timeline.
     float sb = 0.0f, se = 0.0f;
-    String json_path = animation_key;
-    if (_find_marker_range(json_path, marker, sb, se)) {
-        if (animation) animation->segment(sb, se);
-        _post_segment_to_worker(sb, se);
+    if (marker.is_empty() || !_find_marker_range(marker, sb, se)) {
+        if (!segment_applied) return;
+        sb = 0.0f;
+        se = total_frames;
     }
+    _apply_segment(sb, se);
+}
+
+void LottieAnimation::_apply_segment(float begin, float end) {
+    if (animation) animation->segment(begin, end);
+    segment_applied = begin > 0.0f || end < total_frames;
+    segment_key = segment_applied ? _segment_suffix(begin, end) : String();
+    disk_cache_key = String();
+    _post_segment_to_worker(begin, end);
+    _invalidate_loop_bake();
 }
 
 void LottieAnimation::_update_resolution_from_scale() {
     if (!is_inside_tree()) {
         return; // transforms not valid yet
     }
-    // Compute effective on-screen scale combining node-to-canvas and viewport final transform (camera/editor zoom)
-    Transform2D screen_xform;
-    if (get_viewport()) {
-        screen_xform = get_viewport()->get_final_transform() * get_global_transform_with_canvas();
-    } else {
-        // Fallback: CanvasItem's screen transform already represents local->screen
-        screen_xform = get_screen_transform();
-    }
-    // Column vectors magnitude approximate scale along axes
-    float sx = screen_xform.columns[0].length();
-    float sy = screen_xform.columns[1].length();
+    // Effective on-screen scale: canvas-to-screen (viewport final transform and camera/editor zoom, pushed
+    // once per frame per canvas by LottieResolutionManager) times this node's own node-to-canvas scale.
     // Use actual scale (can be < 1 when zooming out) so we downscale the render target for crisp results at any zoom.
-    float max_scale = std::max(std::abs(sx), std::abs(sy));
+    float max_scale = canvas_scale * node_scale;
+    if (resolution_size_classes && max_scale > 0.0f) {
+        // Round up to the next power of sqrt(2): a zoom only changes the size when it crosses a
+        // class, and every node zoomed into the same class shares cached frames.
+        const float k = std::ceil(std::log2(max_scale) * 2.0f - 1e-3f);
+        max_scale = std::exp2(k * 0.5f);
+    }
     Vector2 desired = Vector2((float)fit_box_size.x, (float)fit_box_size.y) * max_scale;
     Vector2i desired_i((int)std::ceil(desired.x), (int)std::ceil(desired.y));
     // Quantize to 16px grid to reduce realloc churn and improve cache hit rate
@@ -1296,6 +2529,7 @@ void LottieAnimation::_update_resolution_from_scale() {
     // Removed scale debug print
         last_effective_scale = max_scale;
     }
+    if (desired_i != last_desired_size) _desired_changed_at = _elapsed_time;
     last_desired_size = desired_i;
     // If already at desired target, skip.
     if (desired_i == render_size) {
@@ -1312,6 +2546,7 @@ void LottieAnimation::_update_resolution_from_scale() {
 }
 
 void LottieAnimation::_on_viewport_size_changed() {
+    _wake();
     if (dynamic_resolution) {
         // Only compute desired size and defer actual reallocations/renders to _process
         _update_resolution_from_scale();
@@ -1344,6 +2579,7 @@ bool LottieAnimation::is_fit_into_box() const { return fit_into_box; }
 void LottieAnimation::set_fit_box_size(const Vector2i &p_size) {
     if (fit_box_size == p_size) return;
     fit_box_size = p_size;
+    _wake(); // the new target size needs a render
     if (canvas && picture && fit_into_box) {
         _apply_sizing_policy();
         _apply_picture_transform_to_fit();
@@ -1351,12 +2587,86 @@ void LottieAnimation::set_fit_box_size(const Vector2i &p_size) {
 }
 Vector2i LottieAnimation::get_fit_box_size() const { return fit_box_size; }
 
-void LottieAnimation::set_dynamic_resolution(bool p_enable) { dynamic_resolution = p_enable; }
+void LottieAnimation::set_dynamic_resolution(bool p_enable) {
+    dynamic_resolution = p_enable;
+    _update_resolution_registration();
+}
+
+void LottieAnimation::_update_resolution_registration() {
+    const bool want = dynamic_resolution && is_inside_tree();
+    if (want == resolution_registered) return;
+    resolution_registered = want;
+    if (want) {
+        _refresh_node_scale();
+        LottieResolutionManager::get_singleton()->register_node(this);
+    } else {
+        LottieResolutionManager::get_singleton()->unregister_node(this);
+    }
+}
+
+void LottieAnimation::_refresh_node_scale() {
+    const Transform2D xform = get_global_transform();
+    node_scale = std::max(std::abs(xform.columns[0].length()), std::abs(xform.columns[1].length()));
+}
+
+void LottieAnimation::_on_canvas_scale_changed(float p_scale) {
+    canvas_scale = p_scale;
+    if (frame_stream) return;
+    _update_resolution_from_scale();
+    if (pending_resize) _wake();
+}
 bool LottieAnimation::is_dynamic_resolution() const { return dynamic_resolution; }
 
 void LottieAnimation::set_resolution_threshold(float p_t) { resolution_threshold = std::clamp(p_t, 0.01f, 1.0f); }
 float LottieAnimation::get_resolution_threshold() const { return resolution_threshold; }
 
+void LottieAnimation::set_lookahead_frames(int p_frames) {
+    lookahead_frames = std::clamp(p_frames, 0, LOOKAHEAD_MAX);
+    if (lookahead_frames == 0 && lookahead_active) _clear_lookahead();
+}
+int LottieAnimation::get_lookahead_frames() const { return lookahead_frames; }
+
+void LottieAnimation::set_render_thread_enabled(bool p_enable) {
+#ifdef __EMSCRIPTEN__
+    p_enable = false; // no std::thread on the web build
+#endif
+    if (render_thread_enabled == p_enable) return;
+    if (lookahead_active) _clear_lookahead();
+    _stop_worker();
+    {
+        std::lock_guard<std::mutex> lk(frame_mutex);
+        latest_frame.ready = false;
+    }
+    LottieRenderScheduler::get_singleton()->cancel(this);
+    _cancel_slice();
+    render_thread_enabled = p_enable;
+    if (render_thread_enabled && canvas && !resources_released) {
+        _start_worker_if_needed();
+        _repost_worker_state();
+    }
+    // Whichever path renders now starts from scratch
+    main_tiles.invalidate();
+    main_tiles_texture.unref();
+    worker_upload_texture.unref();
+    last_rendered_qf = -1;
+    last_posted_qf = -1;
+    last_posted_size = Vector2i(0, 0);
+    _wake();
+}
+bool LottieAnimation::is_render_thread_enabled() const { return render_thread_enabled; }
+
+void LottieAnimation::set_release_hidden_after(float p_seconds) { release_hidden_after = std::max(0.0f, p_seconds); }
+float LottieAnimation::get_release_hidden_after() const { return release_hidden_after; }
+
+void LottieAnimation::set_resolution_size_classes(bool p_enable) { resolution_size_classes = p_enable; }
+bool LottieAnimation::is_resolution_size_classes() const { return resolution_size_classes; }
+
+void LottieAnimation::set_progressive_resize(bool p_enable) { progressive_resize = p_enable; }
+bool LottieAnimation::is_progressive_resize() const { return progressive_resize; }
+
+void LottieAnimation::set_progressive_settle_time(float p_seconds) { progressive_settle_time = std::max(0.0f, p_seconds); }
+float LottieAnimation::get_progressive_settle_time() const { return progressive_settle_time; }
+
 void LottieAnimation::set_max_render_size(const Vector2i &p_size) { max_render_size = p_size; }
 Vector2i LottieAnimation::get_max_render_size() const { return max_render_size; }
 
@@ -1364,12 +2674,28 @@ void LottieAnimation::set_frame_cache_enabled(bool p_enable) { frame_cache_enabl
 bool LottieAnimation::is_frame_cache_enabled() const { return frame_cache_enabled; }
 void LottieAnimation::set_frame_cache_budget_mb(int p_mb) { frame_cache_budget_mb = std::max(16, p_mb); }
 int LottieAnimation::get_frame_cache_budget_mb() const { return frame_cache_budget_mb; }
-void LottieAnimation::set_frame_cache_step(int p_step) { frame_cache_step = std::max(1, p_step); }
+void LottieAnimation::set_frame_cache_step(int p_step) { frame_cache_step = std::max(1, p_step); _invalidate_loop_bake(); }
 int LottieAnimation::get_frame_cache_step() const { return frame_cache_step; }
+void LottieAnimation::set_loop_bake_enabled(bool p_enable) { loop_bake_enabled = p_enable; if (!p_enable) _invalidate_loop_bake(); }
+bool LottieAnimation::is_loop_bake_enabled() const { return loop_bake_enabled; }
+void LottieAnimation::set_loop_bake_budget_mb(int p_mb) { loop_bake_budget_mb = std::max(1, p_mb); _invalidate_loop_bake(); }
+int LottieAnimation::get_loop_bake_budget_mb() const { return loop_bake_budget_mb; }
+void LottieAnimation::set_disk_cache_enabled(bool p_enable) {
+    disk_cache_enabled = p_enable;
+    if (p_enable) LottieDiskCache::get_singleton()->set_budget_bytes((uint64_t)disk_cache_budget_mb * 1024ull * 1024ull);
+}
+bool LottieAnimation::is_disk_cache_enabled() const { return disk_cache_enabled; }
+void LottieAnimation::set_disk_cache_budget_mb(int p_mb) {
+    disk_cache_budget_mb = std::max(16, p_mb);
+    if (disk_cache_enabled) LottieDiskCache::get_singleton()->set_budget_bytes((uint64_t)disk_cache_budget_mb * 1024ull * 1024ull);
+}
+int LottieAnimation::get_disk_cache_budget_mb() const { return disk_cache_budget_mb; }
+bool LottieAnimation::is_loop_baked() const { return !loop_bake_frames.empty() && loop_bake_filled >= loop_bake_expected; }
 void LottieAnimation::set_engine_option(int p_opt) { engine_option = (p_opt == 1 ? 1 : 0); }
 int LottieAnimation::get_engine_option() const { return engine_option; }
 void LottieAnimation::render_static() {
-    if (!animation) return;
+    _wake();
+    if (!animation && !frame_stream) return;
     if (render_thread_enabled) {
         // Force a one-shot render upload by calling main-thread render (safe, uses current frame)
         _render_frame();
@@ -1388,11 +2714,22 @@ void LottieAnimation::set_live_cache_force(bool p_force) { live_cache_force = p_
 bool LottieAnimation::get_live_cache_force() const { return live_cache_force; }
 void LottieAnimation::set_culling_mode(int p_mode) { /* culling disabled */ }
 int LottieAnimation::get_culling_mode() const { return 2; }
+void LottieAnimation::set_clock_group(const String &p_group) {
+    if (p_group == clock_group) return;
+    _clock_group_leave(clock_group);
+    _clock_group_join(p_group);
+    clock_group = p_group;
+}
+String LottieAnimation::get_clock_group() const { return clock_group; }
+void LottieAnimation::set_clock_phase(float p_phase) { clock_phase = p_phase; }
+float LottieAnimation::get_clock_phase() const { return clock_phase; }
+void LottieAnimation::set_phase_buckets(int p_buckets) { phase_buckets = std::max(0, p_buckets); }
+int LottieAnimation::get_phase_buckets() const { return phase_buckets; }
 void LottieAnimation::set_culling_margin_px(float p_margin) { }
 float LottieAnimation::get_culling_margin_px() const { return 0.0f; }
 
 void LottieAnimation::play() {
-    if (!animation) {
+    if (!animation && !frame_stream) {
         if (!animation_path.is_empty()) {
             _load_animation(animation_path);
         } else {
@@ -1400,11 +2737,13 @@ void LottieAnimation::play() {
         }
     }
     playing = true;
+    _wake();
 }
 
 void LottieAnimation::stop() {
     playing = false;
     current_frame = 0.0f;
+    _wake(); // shows frame 0
 }
 
 void LottieAnimation::pause() {
@@ -1418,8 +2757,10 @@ void LottieAnimation::seek(float frame) {
 void LottieAnimation::set_frame(float frame) {
     if (total_frames > 0) {
         current_frame = CLAMP(frame, 0.0f, total_frames - 1);
+        if (lookahead_active) _clear_lookahead();
         _render_frame();
         queue_redraw();
+        _wake(); // the worker delivers the frame in a later _process
     }
 }
 
@@ -1428,11 +2769,17 @@ float LottieAnimation::get_frame() const {
 }
 
 void LottieAnimation::set_animation_path(const String& path) {
+    _apply_animation_path(path);
+}
+
+bool LottieAnimation::_apply_animation_path(const String &path) {
+    bool loaded = false;
     if (animation_path != path) {
         animation_path = path;
+        dotlottie_sm.stop();
         if (is_inside_tree()) {
             if (!path.is_empty()) {
-                _load_animation(path);
+                loaded = _load_animation(path);
                 // If not a .lottie, clear manifest/state UI
                 if (!animation_path.to_lower().ends_with(".lottie")) {
                     sm_animation_ids.clear();
@@ -1448,11 +2795,10 @@ void LottieAnimation::set_animation_path(const String& path) {
             } else {
                 // Clear current animation and visuals when path is removed
                 playing = false;
-                if (canvas) {
-                    canvas->remove();
-                }
-                picture = nullptr;
-                animation = nullptr;
+                _release_animation();
+                frame_stream.reset();
+                anim_info.reset();
+                _update_resident_bundle(String());
                 // Clear any pending/last worker frame so it won't upload after clearing
                 {
                     std::lock_guard<std::mutex> lk(frame_mutex);
@@ -1462,8 +2808,10 @@ void LottieAnimation::set_animation_path(const String& path) {
                 }
                 if (buffer) memset(buffer, 0, (size_t)render_size.x * (size_t)render_size.y * sizeof(uint32_t));
                 if (image.is_valid()) {
+                    pixel_bytes.resize((int64_t)render_size.x * (int64_t)render_size.y * 4); // streams don't keep one
                     pixel_bytes.fill(0);
                     image->set_data(render_size.x, render_size.y, false, Image::FORMAT_RGBA8, pixel_bytes);
+                    main_tiles.invalidate();
                 }
                 // Drop current texture reference so _draw no longer draws anything
                 texture.unref();
@@ -1474,6 +2822,7 @@ void LottieAnimation::set_animation_path(const String& path) {
             }
         }
     }
+    return loaded;
 }
 
 String LottieAnimation::get_animation_path() const {
@@ -1559,6 +2908,7 @@ void LottieAnimation::_start_worker_if_needed() {
     worker_stop = false;
     load_pending = false;
     render_pending = false;
+    worker_rendering = false;
     render_thread = std::thread([this]() { _worker_loop(); });
 }
 
@@ -1570,6 +2920,9 @@ void LottieAnimation::_stop_worker() {
     }
     job_cv.notify_all();
     render_thread.join();
+    delete pending_animation;
+    pending_animation = nullptr;
+    load_pending = false;
     _worker_free_resources();
 }
 
@@ -1639,6 +2992,217 @@ bool LottieAnimation::_is_visible_on_screen() const {
     return true;
 }
 
+Ref<ImageTexture> LottieAnimation::_cached_frame(int qf) {
+    Ref<ImageTexture> tex = _loop_bake_lookup(qf);
+    if (tex.is_valid()) return tex;
+    if (_cache_lookup_allowed()) {
+        _ensure_cache_capacity();
+        tex = LottieFrameCache::get_singleton()->get(_frame_cache_key(), qf, render_size);
+        if (tex.is_valid()) return tex;
+    }
+    if (disk_cache_enabled && !animation_key.is_empty()) {
+        LottieDiskCache *disk = LottieDiskCache::get_singleton();
+        // Disk reads finish on the IO thread; ask for the next frames now so they are decoded
+        // by the time playback reaches them.
+        const int step = std::max(1, frame_cache_step);
+        for (int i = 1; i <= 4; i++) {
+            int next = qf + i * step;
+            if (next >= (int)total_frames) {
+                if (!looping || total_frames < 1.0f) break;
+                next %= (int)total_frames;
+            }
+            disk->prefetch(_disk_cache_key(), _quantize_frame((float)next), render_size);
+        }
+        PackedByteArray rgba;
+        if (disk->load(_disk_cache_key(), qf, render_size, rgba)) {
+            Ref<Image> img = Image::create_from_data(render_size.x, render_size.y, false, Image::FORMAT_RGBA8, rgba);
+            tex = ImageTexture::create_from_image(img);
+            // Promote to memory so the next lap doesn't touch the disk
+            _ensure_cache_capacity();
+            uint64_t check = 0;
+            const uint64_t content = lottie_hash_pixels(rgba.ptr(), (size_t)rgba.size(), &check);
+            LottieFrameCache::get_singleton()->put(_frame_cache_key(), qf, render_size, tex, (size_t)rgba.size(), content, check);
+            cache_seeded = true;
+            return tex;
+        }
+    }
+    return Ref<ImageTexture>();
+}
+
+Ref<ImageTexture> LottieAnimation::_cached_frame_nearest(int qf) {
+    if (!_cache_lookup_allowed() || animation_key.is_empty()) return Ref<ImageTexture>();
+    return LottieFrameCache::get_singleton()->get_nearest(_frame_cache_key(), qf, render_size);
+}
+
+String LottieAnimation::_disk_cache_key() {
+    if (disk_cache_key.is_empty() && !animation_key.is_empty()) {
+        // Post-processing changes the pixels and segments renumber frames, so both are part of the key
+        const int flags = (unpremultiply_alpha ? 1 : 0) | (fix_alpha_border ? 2 : 0);
+        disk_cache_key = LottieDiskCache::get_singleton()->content_hash(animation_key) + "_" + String::num_int64(flags) + segment_key;
+    }
+    return disk_cache_key;
+}
+
+bool LottieAnimation::_cache_lookup_allowed() const {
+    if (cache_seeded) return true;
+    return frame_cache_enabled && (!cache_only_when_paused || !playing);
+}
+
+bool LottieAnimation::prewarm(int frame_begin, int frame_end, const Vector2i &size) {
+    return _prewarm_range(frame_begin, frame_end, size, 0.0f, total_frames);
+}
+
+bool LottieAnimation::prewarm_marker(const String &marker, const Vector2i &size) {
+    float sb = 0.0f, se = 0.0f;
+    if (!_find_marker_range(marker, sb, se)) {
+        UtilityFunctions::printerr("prewarm: unknown marker: " + marker);
+        return false;
+    }
+    // Playback applies the marker as a segment and counts frames from its start.
+    return _prewarm_range(0, (int)std::ceil(se - sb) - 1, size, sb, se);
+}
+
+bool LottieAnimation::_prewarm_range(int frame_begin, int frame_end, const Vector2i &size, float seg_begin, float seg_end) {
+    if (!animation || animation_key.is_empty() || loaded_abs_path.is_empty() || total_frames <= 0) {
+        UtilityFunctions::printerr("prewarm: no animation loaded");
+        return false;
+    }
+    Vector2i target = (size.x > 0 && size.y > 0) ? size : render_size;
+    target = Vector2i(std::min(target.x, max_render_size.x), std::min(target.y, max_render_size.y));
+    if (target.x <= 0 || target.y <= 0) return false;
+
+    // Same keys the playback path looks up: quantized frame, clamped size, segment.
+    const bool segment = seg_begin > 0.0f || seg_end < total_frames;
+    const int last = (int)std::ceil(seg_end - seg_begin) - 1;
+    const int step = std::max(1, frame_cache_step);
+    int begin = CLAMP(std::min(frame_begin, frame_end), 0, last);
+    int end = CLAMP(std::max(frame_begin, frame_end), 0, last);
+    PrewarmJob job;
+    job.abs_path8 = std::string(loaded_abs_path.utf8().get_data());
+    job.key = segment ? animation_key + _segment_suffix(seg_begin, seg_end) : animation_key;
+    job.frame_offset = seg_begin;
+    job.size = target;
+    job.base_size = base_picture_size;
+    job.frame_begin = begin + (int)seg_begin;
+    job.frame_end = end + (int)seg_begin;
+    _ensure_cache_capacity();
+    for (int f = (begin / step) * step; f <= end; f += step) {
+        // Hold frames are only folded on the full timeline (see _quantize_frame).
+        const int qf = segment ? f : _quantize_frame((float)f);
+        if (!job.frames.empty() && job.frames.back() == qf) continue; // same static run
+        if (LottieFrameCache::get_singleton()->get(job.key, qf, target).is_valid()) continue;
+        job.frames.push_back(qf);
+    }
+    job.unpremultiply = unpremultiply_alpha;
+    job.fix_border = fix_alpha_border;
+    cache_seeded = true;
+    prewarm_queue.push_back(std::move(job));
+    if (!prewarm_active) _start_next_prewarm();
+    _wake(); // _process polls the job and uploads its frames
+    return true;
+}
+
+bool LottieAnimation::is_prewarming() const {
+    return prewarm_active != nullptr || !prewarm_queue.empty();
+}
+
+void LottieAnimation::_start_next_prewarm() {
+    while (!prewarm_active && !prewarm_queue.empty()) {
+        PrewarmJob job = std::move(prewarm_queue.front());
+        prewarm_queue.pop_front();
+        if (job.frames.empty()) {
+            // Everything was already cached; report right away.
+            emit_signal("prewarm_finished", job.frame_begin, job.frame_end);
+            continue;
+        }
+        // Each chunk parses its own copy of the animation, so only split long ranges.
+        const int threads = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+        job.chunks = CLAMP((int)job.frames.size() / 8, 1, std::min(threads, 4));
+        job.pixels.resize(job.frames.size());
+        prewarm_active.reset(new PrewarmJob(std::move(job)));
+        prewarm_active->group = WorkerThreadPool::get_singleton()->add_group_task(
+            callable_mp(this, &LottieAnimation::_prewarm_render_chunk), prewarm_active->chunks, -1, true, "Lottie prewarm");
+    }
+}
+
+void LottieAnimation::_prewarm_render_chunk(uint32_t chunk) {
+    PrewarmJob *job = prewarm_active.get();
+    const size_t count = job->frames.size();
+    const size_t first = count * chunk / (size_t)job->chunks;
+    const size_t stop = count * (chunk + 1) / (size_t)job->chunks;
+    if (first >= stop) return;
+
+    tvg::Animation *anim = tvg::Animation::gen();
+    tvg::Picture *pic = anim ? anim->picture() : nullptr;
+    if (!pic || pic->load(job->abs_path8.c_str()) != tvg::Result::Success) {
+        if (anim) delete anim;
+        return;
+    }
+    tvg::SwCanvas *cv = tvg::SwCanvas::gen();
+    if (!cv) { delete anim; return; }
+    const int w = job->size.x;
+    const int h = job->size.y;
+    std::vector<uint32_t> argb((size_t)w * (size_t)h, 0u);
+    cv->target(argb.data(), w, w, h, tvg::ColorSpace::ARGB8888S);
+    fit_picture(pic, job->base_size, job->size);
+    if (cv->push(pic) == tvg::Result::Success) {
+        for (size_t i = first; i < stop; ++i) {
+            anim->frame(job->frame_offset + (float)job->frames[i]);
+            cv->update();
+            cv->draw(false);
+            cv->sync();
+            std::vector<uint8_t> &rgba = job->pixels[i];
+            rgba.resize((size_t)w * (size_t)h * 4);
+            lottie_convert_argb_to_rgba(argb.data(), rgba.data(), (size_t)w * (size_t)h);
+            if (job->unpremultiply) _unpremultiply_alpha_rgba(rgba.data(), w, h);
+            if (job->fix_border) _fix_alpha_border_rgba(rgba.data(), w, h);
+        }
+    }
+    // The canvas owns the pushed picture; deleting it first frees the pair.
+    delete cv;
+    delete anim;
+}
+
+void LottieAnimation::_poll_prewarm() {
+    if (!prewarm_active) return;
+    PrewarmJob *job = prewarm_active.get();
+    WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+    if (job->group >= 0) {
+        if (!pool->is_group_task_completed(job->group)) return;
+        pool->wait_for_group_task_completion(job->group);
+        job->group = -1;
+    }
+    // Spread texture creation over a few frames so a long range doesn't hitch.
+    const size_t bytes = (size_t)job->size.x * (size_t)job->size.y * 4;
+    _ensure_cache_capacity();
+    for (int n = 0; n < 8 && job->uploaded < job->frames.size(); ++n, ++job->uploaded) {
+        std::vector<uint8_t> &rgba = job->pixels[job->uploaded];
+        if (rgba.size() != bytes) continue;
+        PackedByteArray pba;
+        pba.resize((int64_t)bytes);
+        memcpy(pba.ptrw(), rgba.data(), bytes);
+        uint64_t check = 0;
+        const uint64_t content = lottie_hash_pixels(rgba.data(), bytes, &check);
+        std::vector<uint8_t>().swap(rgba);
+        Ref<Image> img = Image::create_from_data(job->size.x, job->size.y, false, Image::FORMAT_RGBA8, pba);
+        LottieFrameCache::get_singleton()->put(job->key, job->frames[job->uploaded], job->size, ImageTexture::create_from_image(img), bytes, content, check);
+    }
+    if (job->uploaded < job->frames.size()) return;
+    const int begin = job->frame_begin;
+    const int end = job->frame_end;
+    prewarm_active.reset();
+    emit_signal("prewarm_finished", begin, end);
+    _start_next_prewarm();
+}
+
+void LottieAnimation::_wait_prewarm() {
+    prewarm_queue.clear();
+    if (prewarm_active && prewarm_active->group >= 0) {
+        WorkerThreadPool::get_singleton()->wait_for_group_task_completion(prewarm_active->group);
+    }
+    prewarm_active.reset();
+}
+
 void LottieAnimation::_recompute_live_cache_state() {
     if (!frame_cache_enabled) { live_cache_active = false; return; }
     if (live_cache_force) { live_cache_active = true; return; }
@@ -1648,15 +3212,24 @@ void LottieAnimation::_recompute_live_cache_state() {
     if (live_cache_active) cache_only_when_paused = false;
 }
 
-void LottieAnimation::_post_load_to_worker(const String& path) {
-    if (!render_thread_enabled) return;
+void LottieAnimation::_post_load_to_worker(const String& path, tvg::Animation *parsed) {
+    worker_load_path = path; // also kept without the worker, for when it gets enabled
+    if (!render_thread_enabled) {
+        delete parsed;
+        return;
+    }
+    if (lookahead_active) _clear_lookahead();
     std::lock_guard<std::mutex> lk(job_mutex);
+    // A load the worker has not taken yet is superseded, along with its parsed copy.
+    delete pending_animation;
+    pending_animation = parsed;
     if (path.is_empty()) {
         pending_path8.clear();
     } else {
         String absolute_path = ProjectSettings::get_singleton()->globalize_path(path);
         pending_path8 = absolute_path.utf8().get_data();
     }
+    // The worker mirrors the main-thread pool: drop it on bundle change, keep the outgoing animation otherwise.
     load_pending = true;
     job_cv.notify_one();
 }
@@ -1672,6 +3245,7 @@ void LottieAnimation::_post_render_to_worker(const Vector2i &size, float frame)
 
 void LottieAnimation::_post_segment_to_worker(float begin, float end) {
     if (!render_thread_enabled) return;
+    if (lookahead_active) _clear_lookahead(); // predicted frames used the old segment
     std::lock_guard<std::mutex> lk(job_mutex);
     pending_segment_begin = begin;
     pending_segment_end = end;
@@ -1684,34 +3258,29 @@ void LottieAnimation::_worker_free_resources() {
         w_canvas->remove();
     }
     if (w_canvas) { delete w_canvas; w_canvas = nullptr; }
-    if (w_buffer) { delete[] w_buffer; w_buffer = nullptr; }
+    if (w_buffer) { LottieBufferPool::get_singleton()->release_pixels(w_buffer, w_render_size); w_buffer = nullptr; }
+    // Canvas is gone, so the animation holds the only reference to its picture.
+    if (w_animation) LottieResidentPool::get_singleton()->give(w_loaded_path8, w_animation, w_total_frames);
+    w_loaded_path8.clear();
     w_animation = nullptr;
     w_picture = nullptr;
     w_render_size = Vector2i(0,0);
+    std::vector<uint8_t>().swap(w_rgba);
+    w_tiles.invalidate();
 }
 
 void LottieAnimation::_worker_apply_target_if_needed(const Vector2i &size) {
     if (w_render_size == size && w_buffer) return;
-    if (w_buffer) { delete[] w_buffer; w_buffer = nullptr; }
+    if (w_buffer) { LottieBufferPool::get_singleton()->release_pixels(w_buffer, w_render_size); w_buffer = nullptr; }
     w_render_size = size;
-    w_buffer = new uint32_t[(size_t)size.x * (size_t)size.y];
-    memset(w_buffer, 0, (size_t)size.x * (size_t)size.y * sizeof(uint32_t));
+    w_buffer = LottieBufferPool::get_singleton()->acquire_pixels(size);
     w_canvas->target(w_buffer, size.x, size.x, size.y, tvg::ColorSpace::ARGB8888S);
     // Fit transform will be recomputed below
 }
 
 void LottieAnimation::_worker_apply_fit_transform() {
     if (!w_picture) return;
-    float pw = std::max(1.0f, (float)w_base_picture_size.x);
-    float ph = std::max(1.0f, (float)w_base_picture_size.y);
-    float sx = (float)w_render_size.x / pw;
-    float sy = (float)w_render_size.y / ph;
-    float s = std::min(sx, sy);
-    tvg::Matrix m;
-    m.e11 = s;   m.e12 = 0.0f; m.e13 = (w_render_size.x - pw * s) * 0.5f;
-    m.e21 = 0.0f; m.e22 = s;   m.e23 = (w_render_size.y - ph * s) * 0.5f;
-    m.e31 = 0.0f; m.e32 = 0.0f; m.e33 = 1.0f;
-    w_picture->transform(m);
+    fit_picture(w_picture, w_base_picture_size, w_render_size);
 }
 
 void LottieAnimation::_worker_loop() {
@@ -1727,12 +3296,13 @@ void LottieAnimation::_worker_loop() {
     while (true) {
         {
             std::unique_lock<std::mutex> lk(job_mutex);
-            job_cv.wait(lk, [this]{ return worker_stop || load_pending || render_pending; });
+            job_cv.wait(lk, [this]{ return worker_stop || load_pending || render_pending || !pending_ahead.empty(); });
             if (worker_stop) break;
         }
         // 1) Handle LOAD first if pending
         bool do_load = false;
         std::string path8_local;
+        tvg::Animation *parsed_local = nullptr;
     bool do_segment = false;
     float seg_begin_local = 0.0f;
     float seg_end_local = 0.0f;
@@ -1740,6 +3310,8 @@ void LottieAnimation::_worker_loop() {
             std::lock_guard<std::mutex> lk(job_mutex);
             if (load_pending) {
                 path8_local = pending_path8;
+                parsed_local = pending_animation;
+                pending_animation = nullptr;
                 load_pending = false;
                 do_load = true;
             }
@@ -1751,29 +3323,38 @@ void LottieAnimation::_worker_loop() {
             }
         }
         if (do_load) {
+            w_tiles.invalidate();
             // (Re)load animation in worker thread
-            // Clean previous
+            // Clean previous; the outgoing animation goes back to the bundle pool when resident.
             if (w_picture) w_canvas->remove();
+            if (w_animation) LottieResidentPool::get_singleton()->give(w_loaded_path8, w_animation, w_total_frames);
+            w_animation = nullptr;
+            w_picture = nullptr;
+            w_loaded_path8 = path8_local;
+            tvg::Animation *anim = nullptr;
             if (path8_local.empty()) {
                 // Clear resources request
-                w_animation = nullptr;
-                w_picture = nullptr;
-            } else {
-                w_animation = tvg::Animation::gen();
-                w_picture = w_animation->picture();
-                if (w_picture && w_picture->load(path8_local.c_str()) == tvg::Result::Success) {
-                    float pw = 0.0f, ph = 0.0f;
-                    w_picture->size(&pw, &ph);
-                    if (pw <= 0 || ph <= 0) { pw = (float)render_size.x; ph = (float)render_size.y; }
-                    w_base_picture_size = Vector2i((int)std::ceil(pw), (int)std::ceil(ph));
-                    if (w_canvas->push(w_picture) == tvg::Result::Success) {
-                        // ok
-                    } else {
-                        w_animation = nullptr;
-                        w_picture = nullptr;
-                    }
+                delete parsed_local;
+            } else if (parsed_local) {
+                anim = parsed_local; // parsed ahead of time by the preloader
+            } else if (!(anim = LottieResidentPool::get_singleton()->take(path8_local))) {
+                anim = tvg::Animation::gen();
+                if (!anim->picture() || anim->picture()->load(path8_local.c_str()) != tvg::Result::Success) {
+                    delete anim;
+                    anim = nullptr;
+                }
+            }
+            if (anim) {
+                w_picture = anim->picture();
+                float pw = 0.0f, ph = 0.0f;
+                w_picture->size(&pw, &ph);
+                if (pw <= 0 || ph <= 0) { pw = (float)render_size.x; ph = (float)render_size.y; }
+                w_base_picture_size = Vector2i((int)std::ceil(pw), (int)std::ceil(ph));
+                if (w_canvas->push(w_picture) == tvg::Result::Success) {
+                    w_animation = anim;
+                    w_total_frames = anim->totalFrame(); // no segment yet: the full timeline
                 } else {
-                    w_animation = nullptr;
+                    delete anim;
                     w_picture = nullptr;
                 }
             }
@@ -1790,36 +3371,83 @@ void LottieAnimation::_worker_loop() {
                 rsize_local = pending_r_size;
                 rframe_local = pending_r_frame;
                 render_pending = false;
+                worker_rendering = true;
             }
         }
         if (rsize_local.x > 0 && rsize_local.y > 0) {
-            if (!w_canvas || !w_animation || !w_picture) continue;
-            _worker_apply_target_if_needed(rsize_local);
-            _worker_apply_fit_transform();
-            w_animation->frame(rframe_local);
-            w_canvas->update();
-            w_canvas->draw(false);
-            w_canvas->sync();
-            std::vector<uint8_t> tmp;
-            tmp.resize((size_t)w_render_size.x * (size_t)w_render_size.y * 4);
-            // Optimized ARGB->RGBA conversion for worker-produced buffer.
-            _convert_argb_to_rgba_optimized(w_buffer, tmp.data(), (size_t)w_render_size.x * (size_t)w_render_size.y);
-            if (unpremultiply_alpha) {
-                _unpremultiply_alpha_rgba(tmp.data(), w_render_size.x, w_render_size.y);
-            }
-            if (fix_alpha_border) {
-                _fix_alpha_border_rgba(tmp.data(), w_render_size.x, w_render_size.y);
+            if (!w_canvas || !w_animation || !w_picture) {
+                std::lock_guard<std::mutex> lk(job_mutex);
+                worker_rendering = false;
+                continue;
             }
+            const int dirty_tiles = _worker_render(rsize_local, rframe_local);
+            std::vector<uint8_t> tmp(w_rgba);
+            const bool after_ahead = w_ahead_dirty;
+            w_ahead_dirty = false;
             {
                 std::lock_guard<std::mutex> lk(frame_mutex);
+                // Unchanged relative to the last frame the main thread took, not just the last one posted
+                // (nor a look-ahead frame rendered in between).
+                latest_frame.unchanged = dirty_tiles == 0 && !after_ahead && (!latest_frame.ready || latest_frame.unchanged);
                 latest_frame.rgba.swap(tmp);
                 latest_frame.w = w_render_size.x;
                 latest_frame.h = w_render_size.y;
+                latest_frame.frame = rframe_local;
                 latest_frame.id = next_frame_id++;
                 latest_frame.ready = true;
             }
+            std::lock_guard<std::mutex> lk(job_mutex);
+            worker_rendering = false;
+            continue;
         }
+        // 3) Look-ahead: with no current frame waiting, render the next predicted one
+        AheadJob ahead;
+        {
+            std::lock_guard<std::mutex> lk(job_mutex);
+            if (render_pending || load_pending || pending_ahead.empty()) continue;
+            ahead = pending_ahead.front();
+            pending_ahead.pop_front();
+            ahead_inflight = true;
+            ahead_inflight_frame = ahead.frame;
+        }
+        const bool rendered = w_canvas && w_animation && w_picture;
+        if (rendered && _worker_render(ahead.size, ahead.frame) > 0) w_ahead_dirty = true;
+        bool stale = false;
+        {
+            std::lock_guard<std::mutex> lk(job_mutex);
+            ahead_inflight = false;
+            stale = ahead.generation != ahead_generation; // seek, segment or load since it was posted
+        }
+        if (rendered && !stale) {
+            FrameResult result;
+            result.rgba = w_rgba;
+            result.w = w_render_size.x;
+            result.h = w_render_size.y;
+            result.frame = ahead.frame;
+            result.ready = true;
+            std::lock_guard<std::mutex> lk(frame_mutex);
+            ahead_results.push_back(std::move(result));
+            if (ahead_results.size() > (size_t)LOOKAHEAD_MAX) ahead_results.erase(ahead_results.begin());
+        }
+    }
+}
+
+int LottieAnimation::_worker_render(const Vector2i &size, float frame) {
+    _worker_apply_target_if_needed(size);
+    _worker_apply_fit_transform();
+    w_animation->frame(frame);
+    w_canvas->update();
+    w_canvas->draw(false);
+    w_canvas->sync();
+    // Convert only the tiles that changed; w_rgba keeps the previous frame for the rest.
+    const size_t frame_bytes = (size_t)w_render_size.x * (size_t)w_render_size.y * 4;
+    if (w_rgba.size() != frame_bytes) {
+        w_rgba.resize(frame_bytes);
+        w_tiles.invalidate();
     }
+    const int dirty_tiles = w_tiles.update(w_buffer, w_render_size.x, w_render_size.y);
+    _convert_dirty_tiles(w_buffer, w_rgba.data(), w_render_size.x, w_render_size.y, w_tiles);
+    return dirty_tiles;
 }
 
 void LottieAnimation::set_offset(const Vector2 &p_offset) {
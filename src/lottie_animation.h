@@ -9,13 +9,23 @@
 #include <godot_cpp/variant/packed_string_array.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/shader_material.hpp>
 #include <vector>
+#include <deque>
 #include <string>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <chrono>
 #include "lottie_frame_cache.h"
+#include "lottie_animation_index.h"
+#include "lottie_preloader.h"
+#include "lottie_dotlottie_state_machine.h"
+#include "lottie_frame_stream.h"
+#include "lottie_pixel_utils.h"
+#include <memory>
+#include <unordered_map>
 
 namespace tvg {
     class SwCanvas;
@@ -27,6 +37,8 @@ namespace godot {
 
 class LottieAnimation : public Node2D {
     GDCLASS(LottieAnimation, Node2D)
+    friend class LottieResolutionManager;
+    friend class LottieRenderScheduler;
 
 private:
     String animation_path;
@@ -41,6 +53,7 @@ private:
     Ref<ImageTexture> texture;
     Ref<Image> image;
     PackedByteArray pixel_bytes;
+    // Slots are leased from LottieBufferPool on first upload; only playing nodes use more than one.
     std::vector<Ref<ImageTexture>> texture_ring;
     int texture_ring_index = 0;
     int texture_ring_size = 3;
@@ -59,6 +72,7 @@ private:
     Vector2i fit_box_size;
     bool dynamic_resolution;
     float resolution_threshold;
+    bool resolution_size_classes = true; // render sizes snap to sqrt(2) steps of the display scale
     Vector2i max_render_size;
     bool frame_cache_enabled = false;
     int frame_cache_budget_mb = 256;
@@ -69,16 +83,46 @@ private:
     bool live_cache_force = false;
     bool live_cache_active = false;
 
+    // Loop baking: a looping animation keeps one texture per quantized frame at a stable size,
+    // so once a loop has played it replays without ThorVG work. Dropped on size/segment change.
+    bool loop_bake_enabled = false;
+    int loop_bake_budget_mb = 64;
+    std::vector<Ref<ImageTexture>> loop_bake_frames;
+    Vector2i loop_bake_size;
+    size_t loop_bake_reserved = 0; // bytes pinned in the shared LottieFrameCache
+    Vector2i loop_bake_seen_size; // size waiting to settle before capture starts
+    double loop_bake_seen_at = -1.0;
+    int loop_bake_filled = 0;
+    int loop_bake_expected = 0; // distinct frames one lap visits
+    bool loop_bake_rejected = false; // loop doesn't fit the budget at this size
+
+    // Persistent frames on disk (LottieDiskCache), keyed by source content hash.
+    bool disk_cache_enabled = false;
+    int disk_cache_budget_mb = 256;
+    String disk_cache_key;
+
+    // Shared timeline: nodes in the same clock group read one clock, optionally with snapped phases.
+    String clock_group;
+    float clock_phase = 0.0f;
+    int phase_buckets = 0;
+
     int culling_mode = 2;
     float culling_margin_px = 0.0f;
 
     bool render_thread_enabled = true;
+    bool slice_queued = false; // waiting in the scheduler queue
+    bool slice_active = false; // frame rasterized into `buffer`, tile rows still being converted
+    int slice_qf = -1;
+    int slice_pass = 0;
+    int slice_row = 0;
     std::thread render_thread;
     std::mutex job_mutex;
     std::condition_variable job_cv;
     bool worker_stop = false;
+    bool worker_rendering = false; // a taken render job has not been posted yet (job_mutex)
     bool load_pending = false;
     std::string pending_path8;
+    tvg::Animation *pending_animation = nullptr; // already parsed copy of pending_path8, owned by the job
     bool render_pending = false;
     Vector2i pending_r_size;
     float pending_r_frame = 0.0f;
@@ -95,18 +139,47 @@ private:
         std::vector<uint8_t> rgba;
         int w = 0;
         int h = 0;
+        float frame = 0.0f;
         uint64_t id = 0;
         bool ready = false;
+        bool unchanged = false; // same pixels as the last frame the main thread took
     } latest_frame;
     std::mutex frame_mutex;
 
+    // Look-ahead pipeline: while playing, frames predicted for the next ticks are rendered
+    // whenever no current frame is waiting, and shown when the playhead reaches them.
+    static constexpr int LOOKAHEAD_MAX = 8;
+    struct AheadJob {
+        Vector2i size;
+        float frame = 0.0f;
+        uint64_t generation = 0;
+    };
+    int lookahead_frames = 2;
+    bool lookahead_active = false; // main thread: something may be queued or stored
+    double _last_delta = 1.0 / 60.0;
+    std::deque<AheadJob> pending_ahead; // job_mutex
+    bool ahead_inflight = false; // job_mutex
+    float ahead_inflight_frame = 0.0f; // job_mutex
+    uint64_t ahead_generation = 0; // job_mutex; bumped when queued predictions become invalid
+    std::vector<FrameResult> ahead_results; // frame_mutex
+    bool w_ahead_dirty = false; // worker: a look-ahead render changed w_rgba since the last posted frame
+
     tvg::SwCanvas* w_canvas = nullptr;
     tvg::Animation* w_animation = nullptr;
     tvg::Picture* w_picture = nullptr;
     uint32_t* w_buffer = nullptr;
     Vector2i w_render_size = Vector2i(0,0);
+    LottieTileDiff w_tiles;
+    std::vector<uint8_t> w_rgba;
+    // Main-thread tile state; pixel_bytes holds the converted previous frame for clean tiles.
+    LottieTileDiff main_tiles;
+    Ref<ImageTexture> main_tiles_texture; // texture last uploaded from pixel_bytes
+    Ref<ImageTexture> worker_upload_texture; // texture last uploaded from a worker frame
     Vector2i w_base_picture_size = Vector2i(0,0);
     float last_effective_scale = 0.0f;
+    float canvas_scale = 1.0f; // canvas-to-screen scale pushed by LottieResolutionManager
+    float node_scale = 1.0f; // node-to-canvas scale, refreshed on transform notifications
+    bool resolution_registered = false;
     Vector2i last_desired_size = Vector2i(0, 0);
     bool pending_resize = false;
     Vector2i pending_target_size = Vector2i(0, 0);
@@ -114,6 +187,14 @@ private:
     double _elapsed_time = 0.0;
     double _last_resize_at = -1.0;
     float _min_resize_interval = 0.10f;
+    bool resources_released = false; // hidden too long: buffers, textures and worker were freed
+    bool load_deferred = false; // started hidden; loads when first shown or played
+    float release_hidden_after = 0.0f; // seconds; 0 keeps resources while hidden
+    double _hidden_since = -1.0;
+    String worker_load_path; // last path posted to the worker, reposted after a restore
+    bool progressive_resize = true;
+    float progressive_settle_time = 0.2f;
+    double _desired_changed_at = -1.0; // last time the scale-derived size moved
     bool _uploaded_this_frame = false;
     int _last_drawn_qf = -1;
 
@@ -128,34 +209,92 @@ private:
     Dictionary sm_states_by_machine;
     Dictionary sm_anim_inner_paths;
     Dictionary sm_state_segments_by_machine;
+    Dictionary sm_machine_sources;
+    LottieDotLottieStateMachine dotlottie_sm;
+    bool dotlottie_sm_pointer_inside = false;
+    std::vector<String> dotlottie_sm_hovered_layers;
     String active_animation_id;
     String active_state_machine;
     String active_state;
+    std::shared_ptr<const LottieAnimationIndex::Info> anim_info;
+
+    // Animations of the current .lottie bundle stay parsed in the shared LottieResidentPool.
+    bool dotlottie_keep_resident = false;
+    int dotlottie_resident_budget_mb = 64;
+    String resident_bundle_path; // bundle this node holds open in the pool
+    std::string w_loaded_path8;
+    float w_total_frames = 0.0f; // w_animation's full timeline, whatever segment is applied
 
     void _initialize_thorvg();
     void _cleanup_thorvg();
     bool _load_animation(const String& path);
     void _update_animation(float delta);
     void _render_frame();
+    // Uploads pixel_bytes (when changed) and feeds the caches with the frame just converted.
+    void _commit_main_frame(int qf, bool changed);
+    // One scheduler step: rasterize, then convert tile rows until `deadline`. True when unfinished.
+    bool _render_slice(const std::chrono::steady_clock::time_point &deadline);
+    void _cancel_slice();
+    void _repost_worker_state();
+    bool _upload_prepared_frame(LottiePreloader::Prepared &prepared);
+    bool _load_frame_stream(const String &path);
+    void _render_stream_frame();
+    // Detaches the main animation from the canvas and hands it to the pool (or frees it).
+    void _release_animation();
+    // Opens `path` in the resident pool when residency applies to it, closing any other bundle.
+    void _update_resident_bundle(const String &path);
+    void _apply_dotlottie_sm_events();
+    void _enter_dotlottie_sm_state(const LottieDotLottieStateMachine::State &state);
+    void _post_dotlottie_sm_interaction(LottieDotLottieStateMachine::InteractionType type);
+    bool _hit_test_layer(const String &layer, const Vector2 &buffer_pos) const;
     void _create_texture();
     void _recreate_texture_ring();
+    bool _ensure_resources();
+    void _release_hidden_resources();
+    void _restore_resources();
+    void _load_deferred();
+    void _wake();
+    void _upload_worker_rgba(const std::vector<uint8_t> &rgba, float frame);
+    bool _take_lookahead_frame(int qf);
+    void _post_lookahead(int qf);
+    void _clear_lookahead();
+    int _worker_render(const Vector2i &size, float frame);
+    bool _can_sleep();
+    int _texture_ring_depth() const;
+    void _shrink_texture_ring(int depth);
+    void _upload_image_to_ring();
     void _allocate_buffer_and_target(const Vector2i &size);
     void _apply_sizing_policy();
     void _apply_picture_transform_to_fit();
     void _update_resolution_from_scale();
+    void _update_resolution_registration();
+    void _refresh_node_scale();
+    void _on_canvas_scale_changed(float p_scale);
     void _on_viewport_size_changed();
     int _quantized_frame_index() const;
+    int _quantize_frame(float frame) const;
+    Ref<ImageTexture> _loop_bake_lookup(int qf);
+    void _loop_bake_store(int qf, const Ref<Image> &frame_image);
+    void _invalidate_loop_bake();
+    Ref<ImageTexture> _cached_frame(int qf);
+    Ref<ImageTexture> _cached_frame_nearest(int qf);
+    String _disk_cache_key();
     void _ensure_cache_capacity();
     bool _is_visible_on_screen() const;
     void _recompute_live_cache_state();
     void _parse_dotlottie_manifest(const String &zip_path);
+    void _read_dotlottie_manifest(const String &zip_path);
     String _extract_json_from_lottie_to_cache(const String &zip_path, const String &inner_path, const String &suffix_key);
     void _apply_selected_state_segment();
+    void _apply_segment(float begin, float end);
+    String _frame_cache_key() const { return animation_key + segment_key; }
+    static String _segment_suffix(float begin, float end) { return "_s" + String::num(begin) + "-" + String::num(end); }
     String _current_state_segment_marker() const;
-    bool _find_marker_range(const String &json_path, const String &marker, float &out_begin, float &out_end) const;
+    bool _find_marker_range(const String &marker, float &out_begin, float &out_end) const;
     void _start_worker_if_needed();
     void _stop_worker();
-    void _post_load_to_worker(const String& path);
+    // `parsed` (optional) is an instance of `path` the worker adopts instead of parsing it again.
+    void _post_load_to_worker(const String& path, tvg::Animation *parsed = nullptr);
     void _post_render_to_worker(const Vector2i &size, float frame);
     void _post_segment_to_worker(float begin, float end);
     void _worker_loop();
@@ -163,12 +302,97 @@ private:
     void _worker_apply_target_if_needed(const Vector2i &size);
     void _worker_apply_fit_transform();
     void _fix_alpha_border_rgba(uint8_t *rgba, int w, int h);
+    void _fix_alpha_border_rgba_rect(uint8_t *rgba, int w, int h, int x0, int y0, int x1, int y1);
+    // ARGB -> post-processed RGBA for the tiles `diff` marked dirty; clean tiles keep their pixels.
+    void _convert_dirty_tiles(const uint32_t *argb, uint8_t *rgba, int w, int h, const LottieTileDiff &diff);
+    // One pass (0 = convert, 1 = alpha-border fix) over the dirty tiles of tile rows [row0, row1).
+    void _convert_dirty_tile_rows(const uint32_t *argb, uint8_t *rgba, int w, int h, const LottieTileDiff &diff, int pass, int row0, int row1);
     void _unpremultiply_alpha_rgba(uint8_t *rgba, int w, int h);
 
+    bool segment_applied = false; // a sub-range segment is active on the main animation
+    // Frame indices are relative to the applied segment, so cached frames are keyed by it:
+    // "_s<begin>-<end>" while a segment is applied, empty otherwise.
+    String segment_key;
     bool segment_pending = false;
     float pending_segment_begin = 0.0f;
     float pending_segment_end = 0.0f;
 
+    // Outgoing animation kept alive while a crossfade runs. Its frames are rasterized by a
+    // WorkerThreadPool task (inline without the render thread); only the upload is on the main thread.
+    struct CrossfadeSource {
+        tvg::SwCanvas *canvas = nullptr;
+        tvg::Animation *animation = nullptr;
+        uint32_t *buffer = nullptr;
+        Vector2i size;
+        float frame = 0.0f;
+        float total_frames = 0.0f;
+        float duration = 0.0f;
+        float speed = 1.0f;
+        bool looping = true;
+        int last_qf = -1;
+        // What the node needs to take the animation back if the incoming load fails, and the
+        // path it returns to the resident pool under.
+        String path;
+        String abs_path;
+        String key;
+        Vector2i base_size;
+        bool segment_applied = false;
+        String segment_key;
+        int64_t task = -1; // WorkerThreadPool task rendering task_frame into rgba
+        float task_frame = 0.0f;
+        std::vector<uint8_t> rgba;
+        Ref<Image> image;
+        Ref<ImageTexture> texture;
+        PackedByteArray pixels;
+    } crossfade_from;
+    bool crossfading = false;
+    float crossfade_progress = 0.0f;
+    RID crossfade_item;
+    Ref<ShaderMaterial> crossfade_material;
+
+    // Frames rasterized ahead of playback into LottieFrameCache on the WorkerThreadPool.
+    // One job runs at a time (split into chunks with private canvases); later requests queue.
+    struct PrewarmJob {
+        std::string abs_path8;
+        String key;
+        float frame_offset = 0.0f; // segment start: frames are stored relative to it
+        Vector2i size;
+        Vector2i base_size;
+        int frame_begin = 0;
+        int frame_end = 0;
+        std::vector<int> frames;
+        std::vector<std::vector<uint8_t>> pixels; // RGBA per frame, empty if rendering failed
+        int chunks = 1;
+        bool unpremultiply = false;
+        bool fix_border = false;
+        int64_t group = -1;
+        size_t uploaded = 0;
+    };
+    std::deque<PrewarmJob> prewarm_queue;
+    std::unique_ptr<PrewarmJob> prewarm_active;
+    // Pre-rendered .lottieframes playback; replaces ThorVG entirely while set.
+    std::unique_ptr<LottieFrameStream> frame_stream;
+    bool cache_seeded = false; // prewarm or disk fed the shared cache: look it up during playback too
+    String loaded_abs_path;
+
+    bool _cache_lookup_allowed() const;
+    void _start_next_prewarm();
+    // Frames [frame_begin, frame_end] of the segment [seg_begin, seg_end), under that segment's keys.
+    bool _prewarm_range(int frame_begin, int frame_end, const Vector2i &size, float seg_begin, float seg_end);
+    void _prewarm_render_chunk(uint32_t chunk);
+    void _poll_prewarm();
+    void _wait_prewarm();
+
+    Rect2 _display_rect() const;
+    bool _draw_crossfade();
+    void _render_crossfade_source(double delta);
+    void _crossfade_render_task();
+    void _upload_crossfade_source();
+    // Body of set_animation_path; true when a new animation was loaded.
+    bool _apply_animation_path(const String &path);
+    void _release_crossfade_source();
+    void _restore_crossfade_source();
+
 protected:
     static void _bind_methods();
     void _get_property_list(List<PropertyInfo> *p_list) const;
@@ -195,6 +419,8 @@ public:
     String get_animation_path() const;
     void set_selected_dotlottie_animation(const String &id);
     String get_selected_dotlottie_animation() const;
+    // Parses an animation in the background so a later set_animation_path() to it is instant.
+    void preload_animation(const String &path);
     
     void set_playing(bool p_playing);
     bool is_playing() const;
@@ -217,6 +443,18 @@ public:
     bool is_dynamic_resolution() const;
     void set_resolution_threshold(float p_t);
     float get_resolution_threshold() const;
+    void set_resolution_size_classes(bool p_enable);
+    bool is_resolution_size_classes() const;
+    void set_lookahead_frames(int p_frames);
+    int get_lookahead_frames() const;
+    void set_render_thread_enabled(bool p_enable);
+    bool is_render_thread_enabled() const;
+    void set_release_hidden_after(float p_seconds);
+    float get_release_hidden_after() const;
+    void set_progressive_resize(bool p_enable);
+    bool is_progressive_resize() const;
+    void set_progressive_settle_time(float p_seconds);
+    float get_progressive_settle_time() const;
     void set_max_render_size(const Vector2i &p_size);
     Vector2i get_max_render_size() const;
 
@@ -226,6 +464,15 @@ public:
     int get_frame_cache_budget_mb() const;
     void set_frame_cache_step(int p_step);
     int get_frame_cache_step() const;
+    void set_loop_bake_enabled(bool p_enable);
+    bool is_loop_bake_enabled() const;
+    void set_loop_bake_budget_mb(int p_mb);
+    int get_loop_bake_budget_mb() const;
+    bool is_loop_baked() const;
+    void set_disk_cache_enabled(bool p_enable);
+    bool is_disk_cache_enabled() const;
+    void set_disk_cache_budget_mb(int p_mb);
+    int get_disk_cache_budget_mb() const;
     void set_engine_option(int p_opt);
     int get_engine_option() const;
     void set_live_cache_threshold(int p_threshold);
@@ -236,6 +483,16 @@ public:
     int get_culling_mode() const;
     void set_culling_margin_px(float p_margin);
     float get_culling_margin_px() const;
+    void set_clock_group(const String &p_group);
+    String get_clock_group() const;
+    void set_clock_phase(float p_phase);
+    float get_clock_phase() const;
+    void set_phase_buckets(int p_buckets);
+    int get_phase_buckets() const;
+    void set_dotlottie_keep_resident(bool p_keep);
+    bool is_dotlottie_keep_resident() const;
+    void set_dotlottie_resident_budget_mb(int p_mb);
+    int get_dotlottie_resident_budget_mb() const;
     
     void set_speed(float p_speed);
     float get_speed() const;
@@ -243,6 +500,40 @@ public:
     void set_render_size(const Vector2i& size);
     Vector2i get_render_size() const;
     
+    // Crossfade: the current animation keeps playing underneath until finish_crossfade().
+    void crossfade_to(const String &path);
+    void set_crossfade_progress(float p_progress);
+    float get_crossfade_progress() const;
+    void finish_crossfade();
+    bool is_crossfading() const;
+    static void release_shared_resources();
+    // Shared with LottieServer.
+    static void ensure_thorvg_initialized();
+    static String resolve_source_path(const String &path);
+    static String mirror_source_to_user_cache(const String &path);
+    // Loads `path` into `picture`, retrying from a user:// mirror when it cannot be read in place.
+    // Returns the absolute path that loaded, or an empty string.
+    static String load_picture(tvg::Picture *picture, const String &path);
+    static void fit_picture(tvg::Picture *picture, const Vector2i &base_size, const Vector2i &size);
+
+    // Native dotLottie state machine (from the current .lottie bundle).
+    bool start_state_machine(const String &machine = String());
+    void stop_state_machine();
+    bool is_state_machine_running() const;
+    String get_state_machine_state() const;
+    bool set_state_machine_input(const String &name, const Variant &value);
+    Variant get_state_machine_input(const String &name) const;
+    void fire_state_machine_event(const String &name);
+    void post_state_machine_pointer(const String &type, const Vector2 &position);
+
+    // Fills the frame cache for [frame_begin, frame_end] at `size` (render size if zero) in the
+    // background; emits prewarm_finished once every frame is in the cache.
+    bool prewarm(int frame_begin, int frame_end, const Vector2i &size = Vector2i());
+    bool prewarm_marker(const String &marker, const Vector2i &size = Vector2i());
+    bool is_prewarming() const;
+    // Renders every frame into a .lottieframes stream that plays back without rasterization.
+    bool bake_frame_stream(const String &output_path, const Vector2i &size = Vector2i(), int keyframe_interval = 30);
+
     float get_duration() const;
     float get_total_frames() const;
     void render_static();
@@ -0,0 +1,207 @@
+#include "lottie_animation_index.h"
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/json.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <algorithm>
+#include <cmath>
+
+using namespace godot;
+
+static LottieAnimationIndex *singleton = nullptr;
+
+LottieAnimationIndex *LottieAnimationIndex::get_singleton() {
+    if (!singleton) singleton = memnew(LottieAnimationIndex);
+    return singleton;
+}
+
+bool LottieAnimationIndex::Info::find_marker(const String &name, float &out_begin, float &out_end) const {
+    if (name.is_empty()) return false;
+    auto it = markers.find(std::string(name.utf8().get_data()));
+    if (it == markers.end()) return false;
+    out_begin = it->second.begin;
+    out_end = it->second.end;
+    return true;
+}
+
+int LottieAnimationIndex::Info::hold_frame(int frame) const {
+    if (frame < 0 || frame >= (int)hold_start.size()) return frame;
+    return hold_start[frame];
+}
+
+std::shared_ptr<const LottieAnimationIndex::Info> LottieAnimationIndex::get_info(const String &json_path) {
+    if (json_path.is_empty()) return nullptr;
+    const std::string key(json_path.utf8().get_data());
+    const uint64_t mtime = FileAccess::get_modified_time(json_path);
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        auto it = _entries.find(key);
+        if (it != _entries.end() && it->second.modified_time == mtime) return it->second.info;
+    }
+    // Parse outside the lock; a concurrent duplicate parse is harmless and rare.
+    std::shared_ptr<const Info> info = _build_info(json_path);
+    if (!info) return nullptr;
+    std::lock_guard<std::mutex> lk(_mutex);
+    Entry &e = _entries[key];
+    e.modified_time = mtime;
+    e.info = info;
+    return info;
+}
+
+void LottieAnimationIndex::clear() {
+    std::lock_guard<std::mutex> lk(_mutex);
+    _entries.clear();
+}
+
+std::shared_ptr<LottieAnimationIndex::Info> LottieAnimationIndex::_build_info(const String &json_path) {
+    String abs = ProjectSettings::get_singleton()->globalize_path(json_path);
+    Ref<FileAccess> f = FileAccess::open(abs, FileAccess::READ);
+    if (f.is_null()) return nullptr;
+    PackedByteArray data = f->get_buffer(f->get_length());
+    f->close();
+    Variant v = JSON::parse_string(data.get_string_from_utf8());
+    if (v.get_type() != Variant::DICTIONARY) return nullptr;
+    Dictionary d = v;
+
+    std::shared_ptr<Info> info = std::make_shared<Info>();
+    // fr: frame rate; markers are expressed in frames in Bodymovin exports.
+    if (d.has("fr")) info->frame_rate = (double)d["fr"];
+    if (d.has("markers") && d["markers"].get_type() == Variant::ARRAY) {
+        Array markers = d["markers"];
+        for (int i = 0; i < markers.size(); i++) {
+            if (markers[i].get_type() != Variant::DICTIONARY) continue;
+            Dictionary mk = markers[i];
+            String name;
+            if (mk.has("cm")) name = (String)mk["cm"]; // common in Bodymovin
+            else if (mk.has("n")) name = (String)mk["n"]; // alternative key
+            if (name.is_empty()) continue;
+            double tm = mk.has("tm") ? (double)mk["tm"] : 0.0; // start frame
+            double dr = mk.has("dr") ? (double)mk["dr"] : 0.0; // duration in frames
+            MarkerRange r;
+            r.begin = (float)tm;
+            r.end = (float)(tm + dr);
+            if (r.end <= r.begin) r.end = r.begin + 1.0f;
+            // First marker with a given name wins, matching the previous linear search.
+            info->markers.emplace(std::string(name.utf8().get_data()), r);
+        }
+    }
+    _build_hold_frames(d, *info);
+    return info;
+}
+
+namespace {
+
+// Marks every frame whose image may differ from the previous one. Keyframe times are mapped from
+// (pre)composition time to root time with `offset + t * scale`.
+struct HoldAnalysis {
+    std::vector<uint8_t> changes;
+    double root_ip = 0.0;
+    Dictionary assets;
+    bool dynamic = false;
+
+    void mark_jump(double t) {
+        // The first frame at or after t shows the new value.
+        const double f = std::ceil(t - root_ip - 1e-6);
+        if (f >= 1.0 && f < (double)changes.size()) changes[(size_t)f] = 1;
+    }
+    void mark_range(double t0, double t1) {
+        if (t1 < t0) std::swap(t0, t1);
+        const int first = std::max(1, (int)std::floor(t0 - root_ip) + 1);
+        const int last = std::min((int)changes.size() - 1, (int)std::ceil(t1 - root_ip));
+        for (int f = first; f <= last; ++f) changes[(size_t)f] = 1;
+    }
+
+    void keyframes(const Array &kfs, double offset, double scale) {
+        for (int i = 0; i + 1 < kfs.size(); ++i) {
+            if (kfs[i].get_type() != Variant::DICTIONARY || kfs[i + 1].get_type() != Variant::DICTIONARY) continue;
+            Dictionary a = kfs[i];
+            Dictionary b = kfs[i + 1];
+            const double t0 = offset + (double)a.get("t", 0.0) * scale;
+            const double t1 = offset + (double)b.get("t", 0.0) * scale;
+            const Variant start = a.get("s", Variant());
+            const Variant end = a.has("e") ? a["e"] : b.get("s", Variant());
+            if ((int)a.get("h", 0) == 1) {
+                if (start != b.get("s", Variant())) mark_jump(t1);
+            } else if (start != end) {
+                mark_range(t0, t1);
+            }
+        }
+    }
+
+    // Any dictionary with a keyframe array under "k" is an animated property.
+    void walk(const Variant &v, double offset, double scale) {
+        if (dynamic) return;
+        if (v.get_type() == Variant::ARRAY) {
+            Array arr = v;
+            for (int i = 0; i < arr.size(); ++i) walk(arr[i], offset, scale);
+            return;
+        }
+        if (v.get_type() != Variant::DICTIONARY) return;
+        Dictionary d = v;
+        if (d.has("x") && d["x"].get_type() == Variant::STRING && d.has("k")) {
+            dynamic = true; // expressions can change anything at any time
+            return;
+        }
+        if (d.has("k") && d["k"].get_type() == Variant::ARRAY) {
+            Array k = d["k"];
+            if (k.size() > 0 && k[0].get_type() == Variant::DICTIONARY && ((Dictionary)k[0]).has("t")) {
+                keyframes(k, offset, scale);
+                return;
+            }
+        }
+        Array values = d.values();
+        for (int i = 0; i < values.size(); ++i) walk(values[i], offset, scale);
+    }
+
+    void layers(const Array &list, double offset, double scale, int depth) {
+        if (depth > 8) { dynamic = true; return; }
+        for (int i = 0; i < list.size() && !dynamic; ++i) {
+            if (list[i].get_type() != Variant::DICTIONARY) continue;
+            Dictionary layer = list[i];
+            if (layer.has("tm")) { dynamic = true; return; } // time remapping
+            if (layer.has("ip")) mark_jump(offset + (double)layer["ip"] * scale);
+            if (layer.has("op")) mark_jump(offset + (double)layer["op"] * scale);
+            // ip/op are in parent time; everything inside the layer (its keyframes and precomp
+            // content) runs on the layer clock: start time `st`, stretch `sr`.
+            const double local_offset = offset + (double)layer.get("st", 0.0) * scale;
+            const double local_scale = scale * (double)layer.get("sr", 1.0);
+            walk(layer, local_offset, local_scale);
+            if (layer.has("refId") && assets.has(layer["refId"])) {
+                Dictionary asset = assets[layer["refId"]];
+                if (asset.has("layers") && asset["layers"].get_type() == Variant::ARRAY) {
+                    layers(asset["layers"], local_offset, local_scale, depth + 1);
+                }
+            }
+        }
+    }
+};
+
+}
+
+void LottieAnimationIndex::_build_hold_frames(const Dictionary &root, Info &info) {
+    const double ip = (double)root.get("ip", 0.0);
+    const double op = (double)root.get("op", 0.0);
+    const int frames = (int)std::ceil(op - ip);
+    if (frames <= 1 || frames > 100000 || !root.has("layers") || root["layers"].get_type() != Variant::ARRAY) return;
+
+    HoldAnalysis analysis;
+    analysis.changes.assign((size_t)frames, 0);
+    analysis.root_ip = ip;
+    if (root.has("assets") && root["assets"].get_type() == Variant::ARRAY) {
+        Array assets = root["assets"];
+        for (int i = 0; i < assets.size(); ++i) {
+            if (assets[i].get_type() != Variant::DICTIONARY) continue;
+            Dictionary asset = assets[i];
+            if (asset.has("id")) analysis.assets[asset["id"]] = asset;
+        }
+    }
+    analysis.layers(root["layers"], 0.0, 1.0, 0);
+    if (analysis.dynamic) return;
+
+    info.hold_start.resize((size_t)frames);
+    info.hold_start[0] = 0;
+    for (int f = 1; f < frames; ++f) {
+        info.hold_start[(size_t)f] = analysis.changes[(size_t)f] ? f : info.hold_start[(size_t)f - 1];
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef LOTTIE_ANIMATION_INDEX_H
+#define LOTTIE_ANIMATION_INDEX_H
+
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <vector>
+#include <unordered_map>
+#include <string>
+#include <memory>
+#include <mutex>
+
+namespace godot {
+
+// Per-file metadata extracted once from a Lottie JSON and shared by every node that loads it.
+class LottieAnimationIndex {
+public:
+    struct MarkerRange {
+        float begin = 0.0f;
+        float end = 0.0f;
+    };
+
+    struct Info {
+        double frame_rate = 60.0;
+        std::unordered_map<std::string, MarkerRange> markers;
+        // First frame of the static run each frame belongs to (from keyframe timelines);
+        // empty when the file can't be analysed (expressions, time remapping).
+        std::vector<int> hold_start;
+
+        bool find_marker(const String &name, float &out_begin, float &out_end) const;
+        int hold_frame(int frame) const;
+    };
+
+    static LottieAnimationIndex *get_singleton();
+
+    // Returns the index for a JSON file, parsing it only when first seen or modified on disk.
+    std::shared_ptr<const Info> get_info(const String &json_path);
+    void clear();
+
+private:
+    struct Entry {
+        uint64_t modified_time = 0;
+        std::shared_ptr<const Info> info;
+    };
+
+    std::unordered_map<std::string, Entry> _entries;
+    std::mutex _mutex;
+
+    static std::shared_ptr<Info> _build_info(const String &json_path);
+    static void _build_hold_frames(const Dictionary &root, Info &info);
+};
+
+}
+
+#endif
@@ -0,0 +1,113 @@
+#include "lottie_buffer_pool.h"
+#include <cstring>
+
+using namespace godot;
+
+static LottieBufferPool *singleton = nullptr;
+
+LottieBufferPool *LottieBufferPool::get_singleton() {
+    if (!singleton) singleton = memnew(LottieBufferPool);
+    return singleton;
+}
+
+uint64_t LottieBufferPool::_key(const Vector2i &size) {
+    return ((uint64_t)(uint32_t)size.x << 32) | (uint64_t)(uint32_t)size.y;
+}
+
+uint32_t *LottieBufferPool::acquire_pixels(const Vector2i &size) {
+    const size_t count = (size_t)size.x * (size_t)size.y;
+    uint32_t *pixels = nullptr;
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        const uint64_t key = _key(size);
+        for (auto it = _idle.begin(); it != _idle.end(); ++it) {
+            if (it->pixels && it->key == key) {
+                pixels = it->pixels;
+                _used -= it->bytes;
+                _idle.erase(it);
+                break;
+            }
+        }
+    }
+    if (!pixels) pixels = new uint32_t[count];
+    memset(pixels, 0, count * sizeof(uint32_t));
+    return pixels;
+}
+
+void LottieBufferPool::release_pixels(uint32_t *pixels, const Vector2i &size) {
+    if (!pixels) return;
+    const size_t bytes = (size_t)size.x * (size_t)size.y * sizeof(uint32_t);
+    std::lock_guard<std::mutex> lk(_mutex);
+    if (bytes > _budget) {
+        delete[] pixels;
+        return;
+    }
+    Idle idle;
+    idle.key = _key(size);
+    idle.bytes = bytes;
+    idle.pixels = pixels;
+    _idle.push_front(idle);
+    _used += bytes;
+    _trim_locked(false);
+}
+
+Ref<ImageTexture> LottieBufferPool::acquire_texture(const Vector2i &size) {
+    std::lock_guard<std::mutex> lk(_mutex);
+    const uint64_t key = _key(size);
+    for (auto it = _idle.begin(); it != _idle.end(); ++it) {
+        if (it->texture.is_valid() && it->key == key) {
+            Ref<ImageTexture> tex = it->texture;
+            _used -= it->bytes;
+            _idle.erase(it);
+            return tex;
+        }
+    }
+    return Ref<ImageTexture>();
+}
+
+void LottieBufferPool::release_texture(Ref<ImageTexture> &tex) {
+    // Still drawn or referenced elsewhere (placeholder, frame cache): let it die normally.
+    if (tex.is_null() || tex->get_reference_count() > 1) {
+        tex.unref();
+        return;
+    }
+    const Vector2i size(tex->get_width(), tex->get_height());
+    const size_t bytes = (size_t)size.x * (size_t)size.y * 4;
+    std::lock_guard<std::mutex> lk(_mutex);
+    if (bytes == 0 || bytes > _budget) {
+        tex.unref();
+        return;
+    }
+    Idle idle;
+    idle.key = _key(size);
+    idle.bytes = bytes;
+    idle.texture = tex;
+    tex.unref();
+    _idle.push_front(idle);
+    _used += bytes;
+    _trim_locked(true);
+}
+
+void LottieBufferPool::set_budget_bytes(size_t bytes) {
+    std::lock_guard<std::mutex> lk(_mutex);
+    _budget = bytes;
+    _trim_locked(true);
+}
+
+void LottieBufferPool::clear() {
+    std::lock_guard<std::mutex> lk(_mutex);
+    for (Idle &idle : _idle) delete[] idle.pixels;
+    _idle.clear();
+    _used = 0;
+}
+
+void LottieBufferPool::_trim_locked(bool free_textures) {
+    auto it = _idle.end();
+    while (_used > _budget && it != _idle.begin()) {
+        --it;
+        if (it->texture.is_valid() && !free_textures) continue;
+        _used -= it->bytes;
+        delete[] it->pixels;
+        it = _idle.erase(it);
+    }
+}
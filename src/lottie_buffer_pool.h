@@ -0,0 +1,52 @@
+#ifndef LOTTIE_BUFFER_POOL_H
+#define LOTTIE_BUFFER_POOL_H
+
+#include <godot_cpp/classes/image_texture.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+#include <cstdint>
+#include <list>
+#include <mutex>
+
+namespace godot {
+
+// Process-wide recycler for render targets and textures. Render sizes are already quantized to
+// the 16 px grid, so buffers and textures are reused by exact size; idle ones are kept up to a
+// byte budget, oldest dropped first. Pixel buffers may be used from any thread, textures only
+// from the main thread.
+class LottieBufferPool {
+public:
+    static LottieBufferPool *get_singleton();
+
+    // Zeroed ARGB buffer of size.x * size.y pixels; hand it back with release_pixels.
+    uint32_t *acquire_pixels(const Vector2i &size);
+    void release_pixels(uint32_t *pixels, const Vector2i &size);
+
+    // Idle texture of exactly this size with undefined content, or null when none is pooled.
+    Ref<ImageTexture> acquire_texture(const Vector2i &size);
+    // Pools the texture only when the caller holds the last reference to it.
+    void release_texture(Ref<ImageTexture> &tex);
+
+    void set_budget_bytes(size_t bytes);
+    void clear();
+
+private:
+    struct Idle {
+        uint64_t key = 0;
+        size_t bytes = 0;
+        uint32_t *pixels = nullptr;
+        Ref<ImageTexture> texture;
+    };
+
+    std::mutex _mutex;
+    std::list<Idle> _idle; // most recently released first
+    size_t _used = 0;
+    size_t _budget = 64 * 1024 * 1024;
+
+    static uint64_t _key(const Vector2i &size);
+    // Textures are only freed when called from the main thread.
+    void _trim_locked(bool free_textures);
+};
+
+}
+
+#endif
@@ -0,0 +1,307 @@
+#include "lottie_disk_cache.h"
+#include "lottie_mmap.h"
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/dir_access.hpp>
+#include <algorithm>
+#include <cstring>
+
+using namespace godot;
+
+static LottieDiskCache *singleton = nullptr;
+
+// File layout: magic, width, height, raw RGBA size (little-endian u32 each), then the ZSTD payload.
+static const uint32_t FRAME_MAGIC = 0x3152464cu; // "LFR1"
+static const size_t FRAME_HEADER_SIZE = 16;
+static const size_t MAX_QUEUED_WRITES = 64;
+static const size_t MAX_QUEUED_READS = 16;
+static const size_t MAX_LOADED_FRAMES = 32; // decoded frames waiting for load()
+
+LottieDiskCache *LottieDiskCache::get_singleton() {
+    if (!singleton) singleton = memnew(LottieDiskCache);
+    return singleton;
+}
+
+String LottieDiskCache::_root() {
+    if (_root_abs.is_empty()) {
+        _root_abs = ProjectSettings::get_singleton()->globalize_path("user://lottie_cache/frames");
+    }
+    return _root_abs;
+}
+
+std::string LottieDiskCache::_file_name(const String &content_key, int frame, const Vector2i &size) {
+    String name = content_key + "_" + String::num_int64(size.x) + "x" + String::num_int64(size.y) + "_" + String::num_int64(frame) + ".lfr";
+    return std::string(name.utf8().get_data());
+}
+
+String LottieDiskCache::content_hash(const String &source_path) {
+    const uint64_t mtime = FileAccess::get_modified_time(source_path);
+    SourceHash &entry = _hashes[std::string(source_path.utf8().get_data())];
+    if (entry.md5.is_empty() || entry.modified_time != mtime) {
+        entry.md5 = FileAccess::get_md5(source_path);
+        entry.modified_time = mtime;
+    }
+    return entry.md5;
+}
+
+bool LottieDiskCache::load(const String &content_key, int frame, const Vector2i &size, PackedByteArray &out_rgba) {
+    if (content_key.is_empty() || size.x <= 0 || size.y <= 0) return false;
+    const std::string name = _file_name(content_key, frame, size);
+#ifdef __EMSCRIPTEN__
+    // No IO thread on the nothreads web build: read in place.
+    return _read(_root().path_join(String(name.c_str())), size, out_rgba);
+#else
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        auto it = _loaded.find(name);
+        if (it != _loaded.end()) {
+            out_rgba = it->second;
+            _loaded.erase(it);
+            _loaded_order.erase(std::find(_loaded_order.begin(), _loaded_order.end(), name));
+            auto fit = _files.find(name);
+            if (fit != _files.end()) _lru.splice(_lru.begin(), _lru, fit->second.lru_it);
+            return true;
+        }
+        if (!_queue_read_locked(name, size)) return false;
+    }
+    _start_if_needed();
+    _cv.notify_one();
+    return false;
+#endif
+}
+
+void LottieDiskCache::prefetch(const String &content_key, int frame, const Vector2i &size) {
+#ifndef __EMSCRIPTEN__
+    if (content_key.is_empty() || size.x <= 0 || size.y <= 0) return;
+    const std::string name = _file_name(content_key, frame, size);
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        if (_loaded.count(name) || !_queue_read_locked(name, size)) return;
+    }
+    _start_if_needed();
+    _cv.notify_one();
+#endif
+}
+
+bool LottieDiskCache::_queue_read_locked(const std::string &name, const Vector2i &size) {
+    if (_stop || _reading.count(name) || _reads.size() >= MAX_QUEUED_READS) return false;
+    // Once the directory has been scanned, only files known to exist are worth a read.
+    if (_scanned && !_files.count(name)) return false;
+    Read read;
+    read.name = name;
+    read.abs_path = _root().path_join(String(name.c_str()));
+    read.size = size;
+    _reading.insert(name);
+    _reads.push_back(std::move(read));
+    return true;
+}
+
+bool LottieDiskCache::_read(const String &abs_path, const Vector2i &size, PackedByteArray &out_rgba) {
+    LottieMappedFile file;
+    if (!file.open(abs_path)) return false;
+    if (file.size() <= FRAME_HEADER_SIZE) return false;
+    uint32_t header[4];
+    memcpy(header, file.data(), sizeof(header));
+    const uint32_t raw_size = (uint32_t)size.x * (uint32_t)size.y * 4u;
+    if (header[0] != FRAME_MAGIC || header[1] != (uint32_t)size.x || header[2] != (uint32_t)size.y || header[3] != raw_size) {
+        return false;
+    }
+    PackedByteArray payload;
+    payload.resize((int64_t)(file.size() - FRAME_HEADER_SIZE));
+    memcpy(payload.ptrw(), file.data() + FRAME_HEADER_SIZE, file.size() - FRAME_HEADER_SIZE);
+    file.close();
+    out_rgba = payload.decompress(raw_size, FileAccess::COMPRESSION_ZSTD);
+    return out_rgba.size() == (int64_t)raw_size;
+}
+
+void LottieDiskCache::store(const String &content_key, int frame, const Vector2i &size, const PackedByteArray &rgba) {
+#ifdef __EMSCRIPTEN__
+    // No background writer on the nothreads web build.
+    return;
+#else
+    if (content_key.is_empty() || size.x <= 0 || size.y <= 0) return;
+    if (rgba.size() != (int64_t)size.x * (int64_t)size.y * 4) return;
+    Job job;
+    job.name = _file_name(content_key, frame, size);
+    job.abs_path = _root().path_join(String(job.name.c_str()));
+    job.size = size;
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        if (_stop || _files.count(job.name) || _queued.count(job.name)) return;
+        if (_queue.size() >= MAX_QUEUED_WRITES) return; // writer is behind; the frame can be stored next time
+        job.rgba = rgba;
+        _queued.insert(job.name);
+        _queue.push_back(std::move(job));
+    }
+    _start_if_needed();
+    _cv.notify_one();
+#endif
+}
+
+void LottieDiskCache::set_budget_bytes(uint64_t bytes) {
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _budget = bytes;
+        if (!_scanned) return;
+        _evict_locked();
+        if (_doomed.empty()) return;
+    }
+    _cv.notify_one();
+}
+
+void LottieDiskCache::shutdown() {
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _stop = true;
+    }
+    _cv.notify_all();
+    if (_thread.joinable()) _thread.join();
+    std::lock_guard<std::mutex> lk(_mutex);
+    _queue.clear();
+    _queued.clear();
+    _reads.clear();
+    _reading.clear();
+    _loaded.clear();
+    _loaded_order.clear();
+    _stop = false;
+}
+
+void LottieDiskCache::_start_if_needed() {
+    std::lock_guard<std::mutex> lk(_mutex);
+    if (_thread.joinable() || _stop) return;
+    _root(); // resolve on the calling (main) thread
+    _thread = std::thread([this]() { _thread_loop(); });
+}
+
+void LottieDiskCache::_thread_loop() {
+    _scan();
+    while (true) {
+        _remove_doomed();
+        Read read;
+        Job job;
+        {
+            std::unique_lock<std::mutex> lk(_mutex);
+            _cv.wait(lk, [this]{ return _stop || !_queue.empty() || !_reads.empty() || !_doomed.empty(); });
+            if (!_doomed.empty()) continue;
+            if (_stop) _reads.clear();
+            // Reads go first: a frame is waiting on them. Pending writes are drained before
+            // stopping so the next launch finds them.
+            if (!_reads.empty()) {
+                read = std::move(_reads.front());
+                _reads.pop_front();
+            } else if (!_queue.empty()) {
+                job = std::move(_queue.front());
+                _queue.pop_front();
+            } else {
+                break;
+            }
+        }
+        if (!read.name.empty()) {
+            PackedByteArray rgba;
+            const bool ok = _read(read.abs_path, read.size, rgba);
+            std::lock_guard<std::mutex> lk(_mutex);
+            _reading.erase(read.name);
+            if (!ok) continue;
+            if (_loaded.emplace(read.name, rgba).second) _loaded_order.push_back(read.name);
+            while (_loaded_order.size() > MAX_LOADED_FRAMES) {
+                _loaded.erase(_loaded_order.front());
+                _loaded_order.pop_front();
+            }
+            continue;
+        }
+        _write(job);
+        std::lock_guard<std::mutex> lk(_mutex);
+        _queued.erase(job.name);
+    }
+    _remove_doomed();
+}
+
+void LottieDiskCache::_scan() {
+    DirAccess::make_dir_recursive_absolute(_root_abs);
+    PackedStringArray names = DirAccess::get_files_at(_root_abs);
+    struct Found {
+        std::string name;
+        uint64_t bytes;
+        uint64_t modified;
+    };
+    std::vector<Found> found;
+    for (int i = 0; i < names.size(); i++) {
+        String name = names[i];
+        String path = _root_abs.path_join(name);
+        if (!name.ends_with(".lfr")) {
+            // Leftover temp file from an interrupted write.
+            if (name.ends_with(".tmp")) DirAccess::remove_absolute(path);
+            continue;
+        }
+        Ref<FileAccess> f = FileAccess::open(path, FileAccess::READ);
+        if (f.is_null()) continue;
+        found.push_back({ std::string(name.utf8().get_data()), f->get_length(), FileAccess::get_modified_time(path) });
+    }
+    // Oldest first, so the most recently written files end up at the front of the LRU.
+    std::sort(found.begin(), found.end(), [](const Found &a, const Found &b) { return a.modified < b.modified; });
+    std::lock_guard<std::mutex> lk(_mutex);
+    for (const Found &entry : found) {
+        if (!_files.count(entry.name)) _add_file_locked(entry.name, entry.bytes);
+    }
+    _scanned = true;
+    _evict_locked();
+}
+
+void LottieDiskCache::_write(const Job &job) {
+    if (FileAccess::file_exists(job.abs_path)) return;
+    PackedByteArray payload = job.rgba.compress(FileAccess::COMPRESSION_ZSTD);
+    if (payload.is_empty()) return;
+    // Write to a temp name and rename, so readers never map a partial file.
+    String tmp_path = job.abs_path + ".tmp";
+    Ref<FileAccess> f = FileAccess::open(tmp_path, FileAccess::WRITE);
+    if (f.is_null()) return;
+    f->store_32(FRAME_MAGIC);
+    f->store_32((uint32_t)job.size.x);
+    f->store_32((uint32_t)job.size.y);
+    f->store_32((uint32_t)job.rgba.size());
+    f->store_buffer(payload);
+    f->close();
+    if (DirAccess::rename_absolute(tmp_path, job.abs_path) != OK) {
+        DirAccess::remove_absolute(tmp_path);
+        return;
+    }
+    std::lock_guard<std::mutex> lk(_mutex);
+    _add_file_locked(job.name, FRAME_HEADER_SIZE + (uint64_t)payload.size());
+    _evict_locked();
+}
+
+void LottieDiskCache::_add_file_locked(const std::string &name, uint64_t bytes) {
+    auto it = _files.find(name);
+    if (it != _files.end()) {
+        _used -= it->second.bytes;
+        _lru.erase(it->second.lru_it);
+    } else {
+        it = _files.emplace(name, FileInfo()).first;
+    }
+    _lru.push_front(name);
+    it->second.lru_it = _lru.begin();
+    it->second.bytes = bytes;
+    _used += bytes;
+}
+
+void LottieDiskCache::_evict_locked() {
+    while (_used > _budget && !_lru.empty()) {
+        const std::string &oldest = _lru.back();
+        auto it = _files.find(oldest);
+        if (it != _files.end()) {
+            _used -= it->second.bytes;
+            _files.erase(it);
+        }
+        _doomed.push_back(_root_abs.path_join(String(oldest.c_str())));
+        _lru.pop_back();
+    }
+}
+
+void LottieDiskCache::_remove_doomed() {
+    std::vector<String> doomed;
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        doomed.swap(_doomed);
+    }
+    for (const String &path : doomed) DirAccess::remove_absolute(path);
+}
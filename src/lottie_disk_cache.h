@@ -0,0 +1,93 @@
+#ifndef LOTTIE_DISK_CACHE_H
+#define LOTTIE_DISK_CACHE_H
+
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <deque>
+#include <list>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace godot {
+
+// Persistent tier below LottieFrameCache: rasterized frames stored ZSTD-compressed under
+// user://lottie_cache/frames, keyed by source content hash, size and frame. Writes happen on a
+// background thread, and so do reads (memory-mapped, decompressed there). Least recently used
+// files are evicted past the disk budget.
+class LottieDiskCache {
+public:
+    static LottieDiskCache *get_singleton();
+
+    // MD5 of the source file, computed once per path and modification time.
+    String content_hash(const String &source_path);
+    // Returns a frame the IO thread has already decoded; otherwise queues the read and returns false.
+    bool load(const String &content_key, int frame, const Vector2i &size, PackedByteArray &out_rgba);
+    // Queues a read so a later load() of the frame finds it decoded.
+    void prefetch(const String &content_key, int frame, const Vector2i &size);
+    void store(const String &content_key, int frame, const Vector2i &size, const PackedByteArray &rgba);
+    void set_budget_bytes(uint64_t bytes);
+    // Finishes queued writes and stops the writer thread.
+    void shutdown();
+
+private:
+    struct Job {
+        std::string name;
+        String abs_path;
+        Vector2i size;
+        PackedByteArray rgba;
+    };
+    struct Read {
+        std::string name;
+        String abs_path;
+        Vector2i size;
+    };
+    struct FileInfo {
+        uint64_t bytes = 0;
+        std::list<std::string>::iterator lru_it; // front = most recently used
+    };
+    struct SourceHash {
+        uint64_t modified_time = 0;
+        String md5;
+    };
+
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<Job> _queue;
+    std::unordered_set<std::string> _queued;
+    std::deque<Read> _reads;
+    std::unordered_set<std::string> _reading;
+    std::unordered_map<std::string, PackedByteArray> _loaded;
+    std::deque<std::string> _loaded_order;
+    std::unordered_map<std::string, FileInfo> _files;
+    std::list<std::string> _lru;
+    std::vector<String> _doomed; // evicted files, removed by the IO thread outside the lock
+    std::unordered_map<std::string, SourceHash> _hashes;
+    String _root_abs;
+    uint64_t _used = 0;
+    uint64_t _budget = 256ull * 1024ull * 1024ull;
+    bool _scanned = false;
+    bool _stop = false;
+
+    String _root();
+    static std::string _file_name(const String &content_key, int frame, const Vector2i &size);
+    void _start_if_needed();
+    void _thread_loop();
+    void _scan();
+    bool _queue_read_locked(const std::string &name, const Vector2i &size);
+    static bool _read(const String &abs_path, const Vector2i &size, PackedByteArray &out_rgba);
+    void _write(const Job &job);
+    void _add_file_locked(const std::string &name, uint64_t bytes);
+    void _evict_locked();
+    void _remove_doomed();
+};
+
+}
+
+#endif
@@ -0,0 +1,438 @@
+#include "lottie_dotlottie_state_machine.h"
+
+#include <godot_cpp/classes/json.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+using namespace godot;
+
+// Guardless transitions fire immediately; this bounds chains (and cycles) per evaluation.
+static const int kMaxTransitionsPerEvaluation = 32;
+
+static String _dict_string(const Dictionary &d, const char *key, const char *alias = nullptr) {
+    if (d.has(key)) return (String)d[key];
+    if (alias && d.has(alias)) return (String)d[alias];
+    return String();
+}
+
+static LottieDotLottieStateMachine::InputType _input_type_from_string(const String &type) {
+    if (type == "Boolean") return LottieDotLottieStateMachine::INPUT_BOOLEAN;
+    if (type == "String") return LottieDotLottieStateMachine::INPUT_STRING;
+    if (type == "Event") return LottieDotLottieStateMachine::INPUT_EVENT;
+    return LottieDotLottieStateMachine::INPUT_NUMERIC;
+}
+
+static Variant _coerce_input_value(LottieDotLottieStateMachine::InputType type, const Variant &value) {
+    switch (type) {
+        case LottieDotLottieStateMachine::INPUT_NUMERIC: return (double)value;
+        case LottieDotLottieStateMachine::INPUT_BOOLEAN: return (bool)value;
+        case LottieDotLottieStateMachine::INPUT_STRING: return (String)value;
+        default: return Variant();
+    }
+}
+
+LottieDotLottieStateMachine::InteractionType LottieDotLottieStateMachine::interaction_type_from_string(const String &type) {
+    if (type == "PointerDown") return INTERACTION_POINTER_DOWN;
+    if (type == "PointerUp") return INTERACTION_POINTER_UP;
+    if (type == "PointerEnter") return INTERACTION_POINTER_ENTER;
+    if (type == "PointerExit") return INTERACTION_POINTER_EXIT;
+    if (type == "PointerMove") return INTERACTION_POINTER_MOVE;
+    if (type == "Click") return INTERACTION_CLICK;
+    if (type == "OnComplete") return INTERACTION_ON_COMPLETE;
+    if (type == "OnLoopComplete") return INTERACTION_ON_LOOP_COMPLETE;
+    return INTERACTION_INVALID;
+}
+
+int LottieDotLottieStateMachine::_find_input(const String &name) const {
+    auto it = input_ids.find(std::string(name.utf8().get_data()));
+    return it != input_ids.end() ? it->second : -1;
+}
+
+int LottieDotLottieStateMachine::_find_state(const String &name) const {
+    auto it = state_ids.find(std::string(name.utf8().get_data()));
+    return it != state_ids.end() ? it->second : -1;
+}
+
+bool LottieDotLottieStateMachine::_parse_guard(const Dictionary &d, Guard &out) const {
+    out.input = _find_input(_dict_string(d, "inputName", "contextKey"));
+    if (out.input < 0) return false;
+    out.type = inputs[out.input].type;
+    String cond = _dict_string(d, "conditionType");
+    if (cond == "NotEqual") out.op = GUARD_NOT_EQUAL;
+    else if (cond == "GreaterThan") out.op = GUARD_GREATER;
+    else if (cond == "GreaterThanOrEqual") out.op = GUARD_GREATER_EQUAL;
+    else if (cond == "LessThan") out.op = GUARD_LESS;
+    else if (cond == "LessThanOrEqual") out.op = GUARD_LESS_EQUAL;
+    else out.op = GUARD_EQUAL;
+    if (d.has("compareTo")) {
+        Variant cmp = d["compareTo"];
+        if (cmp.get_type() == Variant::STRING && ((String)cmp).begins_with("$")) {
+            out.compare_input = _find_input(((String)cmp).substr(1));
+        }
+        out.compare_to = _coerce_input_value(out.type, cmp);
+    }
+    return true;
+}
+
+bool LottieDotLottieStateMachine::_parse_action(const Dictionary &d, Action &out) const {
+    String type = _dict_string(d, "type");
+    if (type == "SetNumeric") out.type = ACTION_SET_NUMERIC;
+    else if (type == "SetBoolean") out.type = ACTION_SET_BOOLEAN;
+    else if (type == "SetString") out.type = ACTION_SET_STRING;
+    else if (type == "Increment") out.type = ACTION_INCREMENT;
+    else if (type == "Decrement") out.type = ACTION_DECREMENT;
+    else if (type == "Toggle") out.type = ACTION_TOGGLE;
+    else if (type == "Fire") out.type = ACTION_FIRE;
+    else if (type == "Reset") out.type = ACTION_RESET;
+    else if (type == "SetFrame") out.type = ACTION_SET_FRAME;
+    else if (type == "SetProgress") out.type = ACTION_SET_PROGRESS;
+    else if (type == "FireCustomEvent") out.type = ACTION_FIRE_CUSTOM_EVENT;
+    else return false; // OpenUrl, theming and the like are left to game code
+
+    out.input = _find_input(_dict_string(d, "inputName", "contextKey"));
+    if (d.has("value")) {
+        out.value = d["value"];
+        if (out.value.get_type() == Variant::STRING && ((String)out.value).begins_with("$")) {
+            out.value_input = _find_input(((String)out.value).substr(1));
+        }
+    }
+    const bool needs_input = out.type != ACTION_SET_FRAME && out.type != ACTION_SET_PROGRESS && out.type != ACTION_FIRE_CUSTOM_EVENT;
+    return !needs_input || out.input >= 0;
+}
+
+void LottieDotLottieStateMachine::_parse_actions(const Variant &v, std::vector<Action> &out) const {
+    if (v.get_type() != Variant::ARRAY) return;
+    Array arr = v;
+    for (int i = 0; i < arr.size(); i++) {
+        if (arr[i].get_type() != Variant::DICTIONARY) continue;
+        Action action;
+        if (_parse_action(arr[i], action)) out.push_back(action);
+    }
+}
+
+void LottieDotLottieStateMachine::_parse_transition(const Dictionary &d, std::vector<Transition> &out) const {
+    Transition t;
+    t.to_state = _find_state(_dict_string(d, "toState"));
+    if (t.to_state < 0) return;
+    if (d.has("guards") && d["guards"].get_type() == Variant::ARRAY) {
+        Array guards = d["guards"];
+        for (int i = 0; i < guards.size(); i++) {
+            if (guards[i].get_type() != Variant::DICTIONARY) continue;
+            Guard g;
+            if (!_parse_guard(guards[i], g)) return; // unknown input: never satisfiable
+            t.guards.push_back(g);
+        }
+    }
+    out.push_back(t);
+}
+
+bool LottieDotLottieStateMachine::load(const String &json_text) {
+    inputs.clear();
+    states.clear();
+    interactions.clear();
+    input_ids.clear();
+    state_ids.clear();
+    global_states.clear();
+    events.clear();
+    initial_state = -1;
+    current_state = -1;
+    running = false;
+    dirty = false;
+    fired_event = -1;
+
+    Variant parsed = JSON::parse_string(json_text);
+    if (parsed.get_type() != Variant::DICTIONARY) {
+        UtilityFunctions::printerr("Invalid dotLottie state machine JSON");
+        return false;
+    }
+    Dictionary root = parsed;
+
+    // Inputs ("context_variables" in older bundles)
+    Variant inputs_v = root.has("inputs") ? root["inputs"] : (root.has("context_variables") ? root["context_variables"] : Variant());
+    if (inputs_v.get_type() == Variant::ARRAY) {
+        Array arr = inputs_v;
+        for (int i = 0; i < arr.size(); i++) {
+            if (arr[i].get_type() != Variant::DICTIONARY) continue;
+            Dictionary d = arr[i];
+            Input in;
+            in.name = _dict_string(d, "name", "key");
+            if (in.name.is_empty()) continue;
+            in.type = _input_type_from_string(_dict_string(d, "type"));
+            in.initial = _coerce_input_value(in.type, d.has("value") ? d["value"] : Variant());
+            in.value = in.initial;
+            input_ids[std::string(in.name.utf8().get_data())] = (int)inputs.size();
+            inputs.push_back(in);
+        }
+    }
+
+    // States are registered first so transitions can resolve targets by index.
+    Array states_arr;
+    if (root.has("states") && root["states"].get_type() == Variant::ARRAY) states_arr = root["states"];
+    for (int i = 0; i < states_arr.size(); i++) {
+        if (states_arr[i].get_type() != Variant::DICTIONARY) continue;
+        Dictionary d = states_arr[i];
+        State st;
+        st.name = _dict_string(d, "name");
+        if (st.name.is_empty()) continue;
+        st.global = _dict_string(d, "type") == "GlobalState";
+        st.animation = _dict_string(d, "animation", "animationId");
+        st.segment = _dict_string(d, "segment", "marker");
+        if (d.has("loop")) st.loop = (bool)d["loop"];
+        if (d.has("autoplay")) st.autoplay = (bool)d["autoplay"];
+        if (d.has("speed")) st.speed = (float)(double)d["speed"];
+        state_ids[std::string(st.name.utf8().get_data())] = (int)states.size();
+        if (st.global) global_states.push_back((int)states.size());
+        states.push_back(st);
+    }
+    if (states.empty()) {
+        UtilityFunctions::printerr("dotLottie state machine has no states");
+        return false;
+    }
+    for (int i = 0; i < states_arr.size(); i++) {
+        if (states_arr[i].get_type() != Variant::DICTIONARY) continue;
+        Dictionary d = states_arr[i];
+        int id = _find_state(_dict_string(d, "name"));
+        if (id < 0) continue;
+        State &st = states[id];
+        _parse_actions(d.has("entryActions") ? d["entryActions"] : Variant(), st.entry_actions);
+        _parse_actions(d.has("exitActions") ? d["exitActions"] : Variant(), st.exit_actions);
+        if (d.has("transitions") && d["transitions"].get_type() == Variant::ARRAY) {
+            Array tr = d["transitions"];
+            for (int k = 0; k < tr.size(); k++) {
+                if (tr[k].get_type() == Variant::DICTIONARY) _parse_transition(tr[k], st.transitions);
+            }
+        }
+    }
+    // Older bundles list transitions at the root with an explicit source state.
+    if (root.has("transitions") && root["transitions"].get_type() == Variant::ARRAY) {
+        Array tr = root["transitions"];
+        for (int k = 0; k < tr.size(); k++) {
+            if (tr[k].get_type() != Variant::DICTIONARY) continue;
+            Dictionary d = tr[k];
+            int from = _find_state(_dict_string(d, "fromState"));
+            if (from >= 0) _parse_transition(d, states[from].transitions);
+        }
+    }
+
+    // Interactions ("listeners" in older bundles)
+    Variant inter_v = root.has("interactions") ? root["interactions"] : (root.has("listeners") ? root["listeners"] : Variant());
+    if (inter_v.get_type() == Variant::ARRAY) {
+        Array arr = inter_v;
+        for (int i = 0; i < arr.size(); i++) {
+            if (arr[i].get_type() != Variant::DICTIONARY) continue;
+            Dictionary d = arr[i];
+            Interaction it;
+            it.type = interaction_type_from_string(_dict_string(d, "type"));
+            if (it.type == INTERACTION_INVALID) continue;
+            it.layer = _dict_string(d, "layerName", "target");
+            String state_name = _dict_string(d, "stateName");
+            if (!state_name.is_empty()) {
+                it.state = _find_state(state_name);
+                if (it.state < 0) continue;
+            }
+            _parse_actions(d.has("actions") ? d["actions"] : Variant(), it.actions);
+            interactions.push_back(it);
+        }
+    }
+
+    String initial = _dict_string(root, "initial");
+    if (initial.is_empty() && root.has("descriptor") && root["descriptor"].get_type() == Variant::DICTIONARY) {
+        initial = _dict_string(root["descriptor"], "initial");
+    }
+    initial_state = _find_state(initial);
+    if (initial_state < 0) {
+        for (int i = 0; i < (int)states.size(); i++) {
+            if (!states[i].global) { initial_state = i; break; }
+        }
+    }
+    if (initial_state < 0) initial_state = 0;
+    return true;
+}
+
+void LottieDotLottieStateMachine::start() {
+    if (states.empty()) return;
+    for (Input &in : inputs) in.value = in.initial;
+    fired_event = -1;
+    running = true;
+    current_state = -1;
+    _enter_state(initial_state);
+    _evaluate();
+}
+
+void LottieDotLottieStateMachine::stop() {
+    running = false;
+    dirty = false;
+    fired_event = -1;
+}
+
+const LottieDotLottieStateMachine::State *LottieDotLottieStateMachine::get_state(int index) const {
+    if (index < 0 || index >= (int)states.size()) return nullptr;
+    return &states[index];
+}
+
+bool LottieDotLottieStateMachine::_set_input_value(int input, const Variant &value) {
+    if (input < 0 || inputs[input].type == INPUT_EVENT) return false;
+    Variant coerced = _coerce_input_value(inputs[input].type, value);
+    if (inputs[input].value == coerced) return false;
+    inputs[input].value = coerced;
+    dirty = true;
+    return true;
+}
+
+bool LottieDotLottieStateMachine::set_input(const String &name, const Variant &value) {
+    int input = _find_input(name);
+    if (input < 0) return false;
+    if (_set_input_value(input, value) && running) _evaluate();
+    return true;
+}
+
+Variant LottieDotLottieStateMachine::get_input(const String &name) const {
+    int input = _find_input(name);
+    return input >= 0 ? inputs[input].value : Variant();
+}
+
+void LottieDotLottieStateMachine::fire(const String &event_name) {
+    int input = _find_input(event_name);
+    if (input < 0 || inputs[input].type != INPUT_EVENT || !running) return;
+    fired_event = input;
+    dirty = true;
+    _evaluate();
+    fired_event = -1;
+}
+
+void LottieDotLottieStateMachine::post_interaction(InteractionType type, const std::vector<String> &hit_layers, bool node_hit) {
+    if (!running) return;
+    for (const Interaction &it : interactions) {
+        if (it.type != type) continue;
+        if (it.state >= 0 && it.state != current_state) continue;
+        if (it.layer.is_empty()) {
+            if (!node_hit) continue;
+        } else {
+            bool hit = false;
+            for (const String &layer : hit_layers) { if (layer == it.layer) { hit = true; break; } }
+            if (!hit) continue;
+        }
+        _run_actions(it.actions);
+    }
+    if (dirty) _evaluate();
+}
+
+void LottieDotLottieStateMachine::take_events(std::vector<Event> &out) {
+    out.swap(events);
+    events.clear();
+}
+
+bool LottieDotLottieStateMachine::_guard_passes(const Guard &guard) const {
+    const Input &in = inputs[guard.input];
+    if (guard.type == INPUT_EVENT) return fired_event == guard.input;
+    Variant rhs = guard.compare_input >= 0 ? _coerce_input_value(in.type, inputs[guard.compare_input].value) : guard.compare_to;
+    if (guard.type == INPUT_NUMERIC) {
+        double a = (double)in.value;
+        double b = (double)rhs;
+        switch (guard.op) {
+            case GUARD_EQUAL: return a == b;
+            case GUARD_NOT_EQUAL: return a != b;
+            case GUARD_GREATER: return a > b;
+            case GUARD_GREATER_EQUAL: return a >= b;
+            case GUARD_LESS: return a < b;
+            case GUARD_LESS_EQUAL: return a <= b;
+        }
+        return false;
+    }
+    bool equal = in.value == rhs;
+    if (guard.op == GUARD_EQUAL) return equal;
+    if (guard.op == GUARD_NOT_EQUAL) return !equal;
+    return false;
+}
+
+bool LottieDotLottieStateMachine::_transition_passes(const Transition &transition) const {
+    for (const Guard &g : transition.guards) {
+        if (!_guard_passes(g)) return false;
+    }
+    return true;
+}
+
+void LottieDotLottieStateMachine::_run_actions(const std::vector<Action> &actions) {
+    for (const Action &a : actions) {
+        Variant value = a.value_input >= 0 ? inputs[a.value_input].value : a.value;
+        switch (a.type) {
+            case ACTION_SET_NUMERIC:
+            case ACTION_SET_BOOLEAN:
+            case ACTION_SET_STRING:
+                _set_input_value(a.input, value);
+                break;
+            case ACTION_INCREMENT:
+            case ACTION_DECREMENT: {
+                double step = value.get_type() == Variant::NIL ? 1.0 : (double)value;
+                double current = (double)inputs[a.input].value;
+                _set_input_value(a.input, a.type == ACTION_INCREMENT ? current + step : current - step);
+            } break;
+            case ACTION_TOGGLE:
+                _set_input_value(a.input, !(bool)inputs[a.input].value);
+                break;
+            case ACTION_FIRE:
+                if (inputs[a.input].type == INPUT_EVENT) {
+                    fired_event = a.input;
+                    dirty = true;
+                }
+                break;
+            case ACTION_RESET:
+                _set_input_value(a.input, inputs[a.input].initial);
+                break;
+            case ACTION_SET_FRAME:
+            case ACTION_SET_PROGRESS: {
+                Event e;
+                e.type = a.type == ACTION_SET_FRAME ? EVENT_SET_FRAME : EVENT_SET_PROGRESS;
+                e.state = current_state;
+                e.value = (float)(double)value;
+                events.push_back(e);
+            } break;
+            case ACTION_FIRE_CUSTOM_EVENT: {
+                Event e;
+                e.type = EVENT_CUSTOM;
+                e.state = current_state;
+                e.text = (String)value;
+                events.push_back(e);
+            } break;
+        }
+    }
+}
+
+void LottieDotLottieStateMachine::_enter_state(int state) {
+    if (current_state >= 0) {
+        _run_actions(states[current_state].exit_actions);
+        Event exited;
+        exited.type = EVENT_STATE_EXITED;
+        exited.state = current_state;
+        events.push_back(exited);
+    }
+    current_state = state;
+    Event entered;
+    entered.type = EVENT_STATE_ENTERED;
+    entered.state = state;
+    events.push_back(entered);
+    _run_actions(states[state].entry_actions);
+    dirty = true; // guardless transitions out of the new state fire right away
+}
+
+void LottieDotLottieStateMachine::_evaluate() {
+    for (int step = 0; step < kMaxTransitionsPerEvaluation && running && dirty; ++step) {
+        dirty = false;
+        int target = -1;
+        for (int g : global_states) {
+            for (const Transition &t : states[g].transitions) {
+                if (t.to_state != current_state && _transition_passes(t)) { target = t.to_state; break; }
+            }
+            if (target >= 0) break;
+        }
+        if (target < 0 && current_state >= 0) {
+            for (const Transition &t : states[current_state].transitions) {
+                if (_transition_passes(t)) { target = t.to_state; break; }
+            }
+        }
+        // An event is consumed by the first evaluation that sees it.
+        fired_event = -1;
+        if (target < 0) break;
+        _enter_state(target);
+    }
+    dirty = false;
+}
@@ -0,0 +1,155 @@
+#ifndef LOTTIE_DOTLOTTIE_STATE_MACHINE_H
+#define LOTTIE_DOTLOTTIE_STATE_MACHINE_H
+
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/variant.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <vector>
+#include <unordered_map>
+#include <string>
+
+namespace godot {
+
+// Runtime for the state machines embedded in .lottie bundles (states, transitions, guards,
+// inputs and interactions). Evaluation only happens when an input, event or interaction changed;
+// the owning node drains the resulting events and applies them to playback.
+class LottieDotLottieStateMachine {
+public:
+    enum InputType { INPUT_NUMERIC, INPUT_BOOLEAN, INPUT_STRING, INPUT_EVENT };
+    enum GuardOp { GUARD_EQUAL, GUARD_NOT_EQUAL, GUARD_GREATER, GUARD_GREATER_EQUAL, GUARD_LESS, GUARD_LESS_EQUAL };
+    enum ActionType {
+        ACTION_SET_NUMERIC,
+        ACTION_SET_BOOLEAN,
+        ACTION_SET_STRING,
+        ACTION_INCREMENT,
+        ACTION_DECREMENT,
+        ACTION_TOGGLE,
+        ACTION_FIRE,
+        ACTION_RESET,
+        ACTION_SET_FRAME,
+        ACTION_SET_PROGRESS,
+        ACTION_FIRE_CUSTOM_EVENT,
+    };
+    enum InteractionType {
+        INTERACTION_POINTER_DOWN,
+        INTERACTION_POINTER_UP,
+        INTERACTION_POINTER_ENTER,
+        INTERACTION_POINTER_EXIT,
+        INTERACTION_POINTER_MOVE,
+        INTERACTION_CLICK,
+        INTERACTION_ON_COMPLETE,
+        INTERACTION_ON_LOOP_COMPLETE,
+        INTERACTION_INVALID,
+    };
+    enum EventType { EVENT_STATE_EXITED, EVENT_STATE_ENTERED, EVENT_SET_FRAME, EVENT_SET_PROGRESS, EVENT_CUSTOM };
+
+    struct Input {
+        String name;
+        InputType type = INPUT_NUMERIC;
+        Variant initial;
+        Variant value;
+    };
+
+    struct Guard {
+        int input = -1;
+        InputType type = INPUT_NUMERIC;
+        GuardOp op = GUARD_EQUAL;
+        Variant compare_to;
+        int compare_input = -1; // "$name" references another input
+    };
+
+    struct Action {
+        ActionType type = ACTION_FIRE;
+        int input = -1;
+        Variant value;
+        int value_input = -1;
+    };
+
+    struct Transition {
+        int to_state = -1;
+        std::vector<Guard> guards;
+    };
+
+    struct State {
+        String name;
+        bool global = false;
+        String animation;
+        String segment;
+        bool loop = true;
+        bool autoplay = true;
+        float speed = 1.0f;
+        std::vector<Action> entry_actions;
+        std::vector<Action> exit_actions;
+        std::vector<Transition> transitions;
+    };
+
+    struct Interaction {
+        InteractionType type = INTERACTION_INVALID;
+        String layer;
+        int state = -1; // OnComplete / OnLoopComplete filter
+        std::vector<Action> actions;
+    };
+
+    struct Event {
+        EventType type = EVENT_STATE_ENTERED;
+        int state = -1;
+        String text;
+        float value = 0.0f;
+    };
+
+    bool load(const String &json_text);
+    bool is_loaded() const { return !states.empty(); }
+
+    void start();
+    void stop();
+    bool is_running() const { return running; }
+
+    bool set_input(const String &name, const Variant &value);
+    Variant get_input(const String &name) const;
+    void fire(const String &event_name);
+    // Runs the actions of matching interactions. Layer hits are resolved by the caller;
+    // interactions without a layer match when `node_hit` is set.
+    void post_interaction(InteractionType type, const std::vector<String> &hit_layers, bool node_hit);
+    const std::vector<Interaction> &get_interactions() const { return interactions; }
+
+    int get_current_state() const { return current_state; }
+    const State *get_state(int index) const;
+
+    // Events produced since the last call, in order.
+    void take_events(std::vector<Event> &out);
+
+    static InteractionType interaction_type_from_string(const String &type);
+
+private:
+    std::vector<Input> inputs;
+    std::vector<State> states;
+    std::vector<Interaction> interactions;
+    std::unordered_map<std::string, int> input_ids;
+    std::unordered_map<std::string, int> state_ids;
+    std::vector<int> global_states;
+    int initial_state = -1;
+    int current_state = -1;
+    bool running = false;
+    bool dirty = false;
+    int fired_event = -1;
+    std::vector<Event> events;
+
+    int _find_input(const String &name) const;
+    int _find_state(const String &name) const;
+    bool _parse_guard(const Dictionary &d, Guard &out) const;
+    bool _parse_action(const Dictionary &d, Action &out) const;
+    void _parse_actions(const Variant &v, std::vector<Action> &out) const;
+    void _parse_transition(const Dictionary &d, std::vector<Transition> &out) const;
+
+    bool _set_input_value(int input, const Variant &value);
+    bool _guard_passes(const Guard &guard) const;
+    bool _transition_passes(const Transition &transition) const;
+    void _run_actions(const std::vector<Action> &actions);
+    void _enter_state(int state);
+    void _evaluate();
+};
+
+}
+
+#endif
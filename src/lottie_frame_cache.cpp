@@ -1,5 +1,7 @@
 #include "lottie_frame_cache.h"
 #include <godot_cpp/variant/utility_functions.hpp>
+#include <algorithm>
+#include <cmath>
 
 using namespace godot;
 
@@ -18,35 +20,121 @@ Ref<ImageTexture> LottieFrameCache::get(const String &anim_key, int frame, const
     return it->second.tex;
 }
 
-void LottieFrameCache::put(const String &anim_key, int frame, const Vector2i &size, const Ref<ImageTexture> &tex, size_t bytes) {
+Ref<ImageTexture> LottieFrameCache::get_nearest(const String &anim_key, int frame, const Vector2i &size) {
+    auto sit = _sizes.find(Key{anim_key, frame, 0, 0});
+    if (sit == _sizes.end() || size.x <= 0 || size.y <= 0) return Ref<ImageTexture>();
+    const float aspect = (float)size.x / (float)size.y;
+    Vector2i larger, smaller;
+    for (const Vector2i &s : sit->second) {
+        if (s == size) continue;
+        // The 16 px grid skews small sizes a little; anything further off would draw stretched
+        if (std::abs((float)s.x / (float)s.y - aspect) > aspect * 0.125f) continue;
+        if (s.x >= size.x && s.y >= size.y) {
+            if (larger.x == 0 || s.x * s.y < larger.x * larger.y) larger = s;
+        } else if (s.x * s.y > smaller.x * smaller.y) {
+            smaller = s;
+        }
+    }
+    const Vector2i pick = larger.x > 0 ? larger : smaller;
+    if (pick.x <= 0) return Ref<ImageTexture>();
+    return get(anim_key, frame, pick);
+}
+
+uint64_t LottieFrameCache::_content_key(uint64_t hash, const Vector2i &size) {
+    return hash ^ ((uint64_t)(uint32_t)size.x << 40) ^ ((uint64_t)(uint32_t)size.y << 20);
+}
+
+void LottieFrameCache::put(const String &anim_key, int frame, const Vector2i &size, const Ref<ImageTexture> &tex, size_t bytes, uint64_t content_hash, uint64_t content_check) {
     if (bytes == 0 || tex.is_null()) return;
     Key key{anim_key, frame, size.x, size.y};
+    Entry e;
+    e.tex = tex;
+    e.bytes = bytes;
+    const uint64_t content = content_hash != 0 ? _content_key(content_hash, size) : 0;
+    auto sit = content != 0 ? _shared.find(content) : _shared.end();
+    // A matching key with a different check hash is a collision: keep this frame unshared.
+    if (content != 0 && (sit == _shared.end() || sit->second.check == content_check)) {
+        // Identical pixels (hold frames, shared poses across files) keep one texture.
+        e.content = content;
+        Shared &shared = _shared[e.content];
+        if (shared.refs == 0) {
+            shared.tex = tex;
+            shared.bytes = bytes;
+            shared.check = content_check;
+            _used += bytes;
+        }
+        shared.refs++;
+        e.tex = shared.tex;
+        e.bytes = 0;
+    }
     auto it = _map.find(key);
     if (it != _map.end()) {
         // Replace and adjust usage
-        _used -= it->second.bytes;
-        it->second.tex = tex;
-        it->second.bytes = bytes;
-        _used += bytes;
+        _release(it->second);
+        e.lru_it = it->second.lru_it;
+        it->second = e;
+        _used += e.bytes;
         _touch(key);
     } else {
         _lru.push_front(key);
-        Entry e; e.tex = tex; e.bytes = bytes; e.lru_it = _lru.begin();
+        e.lru_it = _lru.begin();
         _map.emplace(key, e);
-        _used += bytes;
+        _used += e.bytes;
+        _sizes[Key{anim_key, frame, 0, 0}].push_back(size);
     }
     _evict_if_needed();
 }
 
+void LottieFrameCache::_release(Entry &e) {
+    _used -= e.bytes;
+    if (e.content == 0) return;
+    auto it = _shared.find(e.content);
+    if (it == _shared.end()) return;
+    if (--it->second.refs <= 0) {
+        _used -= it->second.bytes;
+        _shared.erase(it);
+    }
+}
+
+void LottieFrameCache::_erase_size(const Key &key) {
+    auto it = _sizes.find(Key{key.anim, key.frame, 0, 0});
+    if (it == _sizes.end()) return;
+    std::vector<Vector2i> &sizes = it->second;
+    for (size_t i = 0; i < sizes.size(); i++) {
+        if (sizes[i].x == key.w && sizes[i].y == key.h) {
+            sizes[i] = sizes.back();
+            sizes.pop_back();
+            break;
+        }
+    }
+    if (sizes.empty()) _sizes.erase(it);
+}
+
 void LottieFrameCache::set_capacity_bytes(size_t bytes) {
     _capacity = bytes;
     _evict_if_needed();
 }
 
+bool LottieFrameCache::reserve_pinned(size_t bytes) {
+    if (_pinned + bytes > _capacity / 2) return false;
+    _pinned += bytes;
+    _used += bytes;
+    _evict_if_needed();
+    return true;
+}
+
+void LottieFrameCache::release_pinned(size_t bytes) {
+    bytes = std::min(bytes, _pinned);
+    _pinned -= bytes;
+    _used -= bytes;
+}
+
 void LottieFrameCache::clear() {
     _map.clear();
+    _shared.clear();
+    _sizes.clear();
     _lru.clear();
-    _used = 0;
+    _used = _pinned;
 }
 
 void LottieFrameCache::_touch(const Key &key) {
@@ -62,7 +150,8 @@ void LottieFrameCache::_evict_if_needed() {
         const Key &old = _lru.back();
         auto it = _map.find(old);
         if (it != _map.end()) {
-            _used -= it->second.bytes;
+            _release(it->second);
+            _erase_size(old);
             _map.erase(it);
         }
         _lru.pop_back();
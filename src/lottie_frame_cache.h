@@ -6,6 +6,7 @@
 #include <godot_cpp/variant/string.hpp>
 #include <unordered_map>
 #include <list>
+#include <vector>
 
 namespace godot {
 
@@ -14,8 +15,18 @@ public:
     static LottieFrameCache *get_singleton();
 
     Ref<ImageTexture> get(const String &anim_key, int frame, const Vector2i &size);
-    void put(const String &anim_key, int frame, const Vector2i &size, const Ref<ImageTexture> &tex, size_t bytes);
+    // Same frame at another resolution with roughly the same aspect: the smallest one at least
+    // `size`, else the largest smaller one. Meant to be drawn scaled while `size` renders.
+    Ref<ImageTexture> get_nearest(const String &anim_key, int frame, const Vector2i &size);
+    // With a content hash, entries whose pixels are identical share one texture and are
+    // charged once against the capacity. `content_check` (a second hash of the same pixels) must
+    // match too, so a 64-bit collision never shows another frame's texture.
+    void put(const String &anim_key, int frame, const Vector2i &size, const Ref<ImageTexture> &tex, size_t bytes, uint64_t content_hash = 0, uint64_t content_check = 0);
     void set_capacity_bytes(size_t bytes);
+    // Frames kept outside the LRU (baked loops) are charged against the same capacity. At most
+    // half of it can be pinned; returns false when `bytes` doesn't fit.
+    bool reserve_pinned(size_t bytes);
+    void release_pinned(size_t bytes);
     void clear();
 
 private:
@@ -39,16 +50,31 @@ private:
 
     struct Entry {
         Ref<ImageTexture> tex;
-        size_t bytes = 0;
+        size_t bytes = 0; // 0 when the texture is shared by content
+        uint64_t content = 0;
         std::list<Key>::iterator lru_it;
     };
 
+    struct Shared {
+        Ref<ImageTexture> tex;
+        size_t bytes = 0;
+        uint64_t check = 0;
+        int refs = 0;
+    };
+
     std::unordered_map<Key, Entry, Key::Hasher> _map;
+    std::unordered_map<uint64_t, Shared> _shared;
+    // Resolutions held per (anim, frame); keys use w = h = 0.
+    std::unordered_map<Key, std::vector<Vector2i>, Key::Hasher> _sizes;
     std::list<Key> _lru;
     size_t _capacity = 256 * 1024 * 1024;
     size_t _used = 0;
+    size_t _pinned = 0;
 
     void _touch(const Key &key);
+    void _release(Entry &e);
+    void _erase_size(const Key &key);
+    static uint64_t _content_key(uint64_t hash, const Vector2i &size);
     void _evict_if_needed();
 };
 
@@ -0,0 +1,222 @@
+#include "lottie_frame_stream.h"
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <algorithm>
+#include <cstring>
+
+using namespace godot;
+
+static const uint32_t STREAM_MAGIC = 0x3153464cu; // "LFS1"
+static const uint32_t STREAM_VERSION = 1;
+static const size_t STREAM_HEADER_SIZE = 40;
+static const size_t RECORD_HEADER_SIZE = 24;
+static const uint32_t RECORD_KEYFRAME = 1;
+static const int READ_AHEAD_FRAMES = 4;
+static const int MAX_STREAM_SIDE = 16384; // larger headers are corrupt, not worth allocating for
+
+template <typename T>
+static T _read_le(const uint8_t *p) {
+    T v;
+    memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+bool LottieFrameStream::open(const String &abs_path) {
+    close();
+    if (!file.open(abs_path) || file.size() < STREAM_HEADER_SIZE) {
+        close();
+        return false;
+    }
+    const uint8_t *h = file.data();
+    if (_read_le<uint32_t>(h) != STREAM_MAGIC || _read_le<uint32_t>(h + 4) != STREAM_VERSION) {
+        close();
+        return false;
+    }
+    size = Vector2i((int)_read_le<uint32_t>(h + 8), (int)_read_le<uint32_t>(h + 12));
+    frame_count = (int)_read_le<uint32_t>(h + 16);
+    fps = _read_le<float>(h + 20);
+    index_offset = _read_le<uint64_t>(h + 32);
+    if (size.x <= 0 || size.y <= 0 || size.x > MAX_STREAM_SIDE || size.y > MAX_STREAM_SIDE ||
+            frame_count <= 0 || fps <= 0.0f || index_offset < STREAM_HEADER_SIZE || index_offset > file.size() ||
+            (file.size() - index_offset) / 8 < (uint64_t)frame_count) {
+        close();
+        return false;
+    }
+    pixels.resize((int64_t)size.x * (int64_t)size.y * 4);
+    pixels.fill(0);
+    decoded_frame = -1;
+    return true;
+}
+
+void LottieFrameStream::close() {
+    file.close();
+    pixels = PackedByteArray();
+    payload = PackedByteArray();
+    size = Vector2i();
+    frame_count = 0;
+    decoded_frame = -1;
+}
+
+bool LottieFrameStream::_record(int frame, Record &out) const {
+    const uint64_t offset = _read_le<uint64_t>(file.data() + index_offset + (uint64_t)frame * 8);
+    if (offset > index_offset || index_offset - offset < RECORD_HEADER_SIZE) return false;
+    const uint8_t *r = file.data() + offset;
+    out.flags = _read_le<uint32_t>(r);
+    out.x = _read_le<uint32_t>(r + 4);
+    out.y = _read_le<uint32_t>(r + 8);
+    out.w = _read_le<uint32_t>(r + 12);
+    out.h = _read_le<uint32_t>(r + 16);
+    out.compressed = _read_le<uint32_t>(r + 20);
+    out.payload = r + RECORD_HEADER_SIZE;
+    if (index_offset - offset - RECORD_HEADER_SIZE < out.compressed) return false;
+    // 64-bit so a corrupt x + w cannot wrap back inside the image
+    return (uint64_t)out.x + out.w <= (uint64_t)size.x && (uint64_t)out.y + out.h <= (uint64_t)size.y;
+}
+
+bool LottieFrameStream::_apply(int frame) {
+    Record rec;
+    if (!_record(frame, rec)) return false;
+    if (rec.w == 0 || rec.h == 0) return true; // identical to the previous frame
+    const uint64_t raw_size = (uint64_t)rec.w * rec.h * 4;
+    // godot-cpp only reaches ZSTD through PackedByteArray; the staging buffer keeps its allocation
+    // across records of similar size.
+    payload.resize(rec.compressed);
+    memcpy(payload.ptrw(), rec.payload, rec.compressed);
+    PackedByteArray raw = payload.decompress(raw_size, FileAccess::COMPRESSION_ZSTD);
+    if (raw.size() != (int64_t)raw_size) return false;
+    if (rec.w == (uint32_t)size.x && rec.h == (uint32_t)size.y) {
+        // Full-frame record (keyframes): the decompressed buffer is the image.
+        pixels = raw;
+        return true;
+    }
+    const uint8_t *src = raw.ptr();
+    uint8_t *dst = pixels.ptrw();
+    const size_t stride = (size_t)size.x * 4;
+    for (uint32_t row = 0; row < rec.h; ++row) {
+        memcpy(dst + (size_t)(rec.y + row) * stride + (size_t)rec.x * 4, src + (size_t)row * rec.w * 4, (size_t)rec.w * 4);
+    }
+    return true;
+}
+
+void LottieFrameStream::_read_ahead(int frame) {
+    const int last = std::min(frame_count - 1, frame + READ_AHEAD_FRAMES);
+    if (frame > last) return;
+    const uint64_t begin = _read_le<uint64_t>(file.data() + index_offset + (uint64_t)frame * 8);
+    const uint64_t end = last + 1 < frame_count ? _read_le<uint64_t>(file.data() + index_offset + (uint64_t)(last + 1) * 8) : index_offset;
+    if (end > begin) file.advise_will_need((size_t)begin, (size_t)(end - begin));
+}
+
+const PackedByteArray *LottieFrameStream::decode(int frame) {
+    if (!is_open()) return nullptr;
+    frame = CLAMP(frame, 0, frame_count - 1);
+    if (frame == decoded_frame) return &pixels;
+    int start = decoded_frame + 1;
+    if (decoded_frame < 0 || frame < decoded_frame) start = 0;
+    // Jump to the nearest keyframe at or before the target unless it is behind where we are.
+    for (int k = frame; k >= start; --k) {
+        Record rec;
+        if (!_record(k, rec)) return nullptr;
+        if (rec.flags & RECORD_KEYFRAME) {
+            start = k;
+            break;
+        }
+    }
+    for (int f = start; f <= frame; ++f) {
+        if (!_apply(f)) {
+            decoded_frame = -1;
+            return nullptr;
+        }
+    }
+    decoded_frame = frame;
+    _read_ahead(frame + 1);
+    return &pixels;
+}
+
+bool LottieFrameStreamWriter::begin(const String &path, const Vector2i &p_size, int p_frame_count, float fps, int p_keyframe_interval) {
+    if (p_size.x <= 0 || p_size.y <= 0 || p_frame_count <= 0) return false;
+    file = FileAccess::open(path, FileAccess::WRITE);
+    if (file.is_null()) return false;
+    size = p_size;
+    frame_count = p_frame_count;
+    keyframe_interval = std::max(1, p_keyframe_interval);
+    previous.clear();
+    offsets.clear();
+    file->store_32(STREAM_MAGIC);
+    file->store_32(STREAM_VERSION);
+    file->store_32((uint32_t)size.x);
+    file->store_32((uint32_t)size.y);
+    file->store_32((uint32_t)frame_count);
+    file->store_float(fps);
+    file->store_32((uint32_t)keyframe_interval);
+    file->store_32(0);
+    file->store_64(0); // index offset, patched in finish()
+    return true;
+}
+
+bool LottieFrameStreamWriter::add_frame(const uint8_t *rgba) {
+    if (file.is_null() || (int)offsets.size() >= frame_count) return false;
+    const size_t stride = (size_t)size.x * 4;
+    const size_t bytes = stride * (size_t)size.y;
+    bool keyframe = previous.empty() || ((int)offsets.size() % keyframe_interval) == 0;
+    int x0 = 0, y0 = 0, x1 = size.x, y1 = size.y;
+    if (!keyframe) {
+        // Bounding box of the pixels that differ from the previous frame.
+        x0 = size.x; y0 = size.y; x1 = 0; y1 = 0;
+        for (int y = 0; y < size.y; ++y) {
+            const uint32_t *a = (const uint32_t *)(rgba + (size_t)y * stride);
+            const uint32_t *b = (const uint32_t *)(previous.data() + (size_t)y * stride);
+            if (memcmp(a, b, stride) == 0) continue;
+            int l = 0, r = size.x - 1;
+            while (a[l] == b[l]) ++l;
+            while (a[r] == b[r]) --r;
+            x0 = std::min(x0, l);
+            x1 = std::max(x1, r + 1);
+            y0 = std::min(y0, y);
+            y1 = y + 1;
+        }
+        if (x1 <= x0) { x0 = y0 = x1 = y1 = 0; }
+        // A delta covering most of the image decodes no faster than a keyframe.
+        if ((int64_t)(x1 - x0) * (y1 - y0) * 10 > (int64_t)size.x * size.y * 6) {
+            keyframe = true;
+            x0 = 0; y0 = 0; x1 = size.x; y1 = size.y;
+        }
+    }
+    const int w = x1 - x0;
+    const int h = y1 - y0;
+    PackedByteArray compressed;
+    if (w > 0 && h > 0) {
+        PackedByteArray raw;
+        raw.resize((int64_t)w * h * 4);
+        uint8_t *dst = raw.ptrw();
+        for (int row = 0; row < h; ++row) {
+            memcpy(dst + (size_t)row * w * 4, rgba + (size_t)(y0 + row) * stride + (size_t)x0 * 4, (size_t)w * 4);
+        }
+        compressed = raw.compress(FileAccess::COMPRESSION_ZSTD);
+        if (compressed.is_empty()) return false;
+    }
+    offsets.push_back(file->get_position());
+    file->store_32(keyframe ? RECORD_KEYFRAME : 0);
+    file->store_32((uint32_t)x0);
+    file->store_32((uint32_t)y0);
+    file->store_32((uint32_t)w);
+    file->store_32((uint32_t)h);
+    file->store_32((uint32_t)compressed.size());
+    if (!compressed.is_empty()) file->store_buffer(compressed);
+    previous.assign(rgba, rgba + bytes);
+    return true;
+}
+
+bool LottieFrameStreamWriter::finish() {
+    if (file.is_null()) return false;
+    bool ok = (int)offsets.size() == frame_count;
+    if (ok) {
+        const uint64_t index_offset = file->get_position();
+        for (uint64_t offset : offsets) file->store_64(offset);
+        file->seek(32);
+        file->store_64(index_offset);
+    }
+    file->close();
+    file.unref();
+    std::vector<uint8_t>().swap(previous);
+    offsets.clear();
+    return ok;
+}
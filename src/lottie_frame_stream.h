@@ -0,0 +1,77 @@
+#ifndef LOTTIE_FRAME_STREAM_H
+#define LOTTIE_FRAME_STREAM_H
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+#include "lottie_mmap.h"
+#include <vector>
+
+namespace godot {
+
+// Pre-rendered frame stream (.lottieframes). Frames are ZSTD-compressed RGBA; a keyframe holds
+// the whole image, other frames only the rectangle that changed since the previous one. An index
+// at the end of the file gives random access: seeking decodes from the nearest keyframe.
+//
+// Layout (little-endian):
+//   header  magic "LFS1", version, width, height, frame_count, fps (f32), keyframe_interval,
+//           reserved, index_offset (u64)
+//   frame   flags (1 = keyframe), x, y, w, h, compressed size, payload
+//   index   frame_count x u64 record offsets
+class LottieFrameStream {
+public:
+    bool open(const String &abs_path);
+    void close();
+    bool is_open() const { return file.is_open(); }
+
+    Vector2i get_size() const { return size; }
+    int get_frame_count() const { return frame_count; }
+    float get_fps() const { return fps; }
+
+    // Decodes `frame` into the internal image and returns it (width * height * 4 bytes, ready for
+    // Image::set_data), or nullptr on a corrupt file. Sequential playback only applies one delta
+    // per frame.
+    const PackedByteArray *decode(int frame);
+
+private:
+    struct Record {
+        uint32_t flags = 0;
+        uint32_t x = 0, y = 0, w = 0, h = 0;
+        uint32_t compressed = 0;
+        const uint8_t *payload = nullptr;
+    };
+
+    LottieMappedFile file;
+    Vector2i size;
+    int frame_count = 0;
+    float fps = 30.0f;
+    uint64_t index_offset = 0;
+    PackedByteArray pixels;
+    PackedByteArray payload; // reused staging for the compressed record
+    int decoded_frame = -1;
+
+    bool _record(int frame, Record &out) const;
+    bool _apply(int frame);
+    void _read_ahead(int frame);
+};
+
+// Writes a .lottieframes file; frames must be added in order.
+class LottieFrameStreamWriter {
+public:
+    bool begin(const String &path, const Vector2i &size, int frame_count, float fps, int keyframe_interval);
+    bool add_frame(const uint8_t *rgba);
+    bool finish();
+
+private:
+    Ref<FileAccess> file;
+    Vector2i size;
+    int frame_count = 0;
+    int keyframe_interval = 30;
+    std::vector<uint8_t> previous;
+    std::vector<uint64_t> offsets;
+};
+
+}
+
+#endif
@@ -0,0 +1,105 @@
+#include "lottie_mmap.h"
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace godot;
+
+LottieMappedFile::~LottieMappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool LottieMappedFile::open(const String &abs_path) {
+    close();
+    HANDLE file = CreateFileW((LPCWSTR)abs_path.utf16().get_data(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(file, &length) || length.QuadPart <= 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    _file = file;
+    _mapping = mapping;
+    _data = (const uint8_t *)view;
+    _size = (size_t)length.QuadPart;
+    return true;
+}
+
+void LottieMappedFile::advise_will_need(size_t offset, size_t length) const {
+    if (!_data || offset >= _size) return;
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = (PVOID)(_data + offset);
+    range.NumberOfBytes = std::min(length, _size - offset);
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+void LottieMappedFile::close() {
+    if (_data) UnmapViewOfFile(_data);
+    if (_mapping) CloseHandle((HANDLE)_mapping);
+    if (_file) CloseHandle((HANDLE)_file);
+    _data = nullptr;
+    _mapping = nullptr;
+    _file = nullptr;
+    _size = 0;
+}
+
+#else
+
+bool LottieMappedFile::open(const String &abs_path) {
+    close();
+    int fd = ::open(abs_path.utf8().get_data(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    void *view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+    _fd = fd;
+    _data = (const uint8_t *)view;
+    _size = (size_t)st.st_size;
+    return true;
+}
+
+void LottieMappedFile::advise_will_need(size_t offset, size_t length) const {
+    if (!_data || offset >= _size) return;
+    // madvise needs a page-aligned start.
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    const size_t start = offset - (offset % page);
+    madvise((void *)(_data + start), std::min(length + (offset - start), _size - start), MADV_WILLNEED);
+}
+
+void LottieMappedFile::close() {
+    if (_data) munmap((void *)_data, _size);
+    if (_fd >= 0) ::close(_fd);
+    _data = nullptr;
+    _fd = -1;
+    _size = 0;
+}
+
+#endif
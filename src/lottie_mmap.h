@@ -0,0 +1,40 @@
+#ifndef LOTTIE_MMAP_H
+#define LOTTIE_MMAP_H
+
+#include <godot_cpp/variant/string.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace godot {
+
+// Read-only memory mapping of a file (absolute path), so cached frames are paged in by the OS
+// instead of being copied through a read buffer.
+class LottieMappedFile {
+public:
+    LottieMappedFile() = default;
+    ~LottieMappedFile();
+    LottieMappedFile(const LottieMappedFile &) = delete;
+    LottieMappedFile &operator=(const LottieMappedFile &) = delete;
+
+    bool open(const String &abs_path);
+    void close();
+    bool is_open() const { return _data != nullptr; }
+    const uint8_t *data() const { return _data; }
+    size_t size() const { return _size; }
+    // Hints the OS to start paging in a range that will be read soon.
+    void advise_will_need(size_t offset, size_t length) const;
+
+private:
+    const uint8_t *_data = nullptr;
+    size_t _size = 0;
+#ifdef _WIN32
+    void *_file = nullptr;
+    void *_mapping = nullptr;
+#else
+    int _fd = -1;
+#endif
+};
+
+}
+
+#endif
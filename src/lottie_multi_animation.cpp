@@ -0,0 +1,374 @@
+#include "lottie_multi_animation.h"
+#include "lottie_animation.h"
+#include "lottie_pixel_utils.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/rendering_server.hpp>
+#include <godot_cpp/classes/shader.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <algorithm>
+#include <cmath>
+
+#include <thorvg.h>
+
+using namespace godot;
+
+static const int kMaxAtlasSide = 4096;
+static const int kInstanceStride = 12;
+
+static Ref<Shader> g_multi_shader;
+
+// Each instance selects its atlas cell from (phase, speed) in INSTANCE_CUSTOM; the CPU mirrors
+// this formula to know which cells must be rasterized.
+static const char *MULTI_SHADER_CODE = R"(
+shader_type canvas_item;
+uniform float clock = 0.0;
+uniform float duration = 1.0;
+uniform int cell_count = 1;
+uniform vec2 grid = vec2(1.0);
+uniform vec2 cell_texels = vec2(128.0);
+varying vec2 cell_origin;
+void vertex() {
+    float t = fract(clock * INSTANCE_CUSTOM.y / duration + INSTANCE_CUSTOM.x);
+    float cell = min(floor(t * float(cell_count)), float(cell_count - 1));
+    cell_origin = vec2(mod(cell, grid.x), floor(cell / grid.x)) / grid;
+}
+void fragment() {
+    // Inset by half a texel so filtering never bleeds in the neighbouring cell.
+    vec2 uv = mix(vec2(0.5) / cell_texels, vec2(1.0) - vec2(0.5) / cell_texels, UV);
+    COLOR = texture(TEXTURE, cell_origin + uv / grid) * COLOR;
+}
+)";
+
+void LottieMultiAnimation::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_animation_path", "path"), &LottieMultiAnimation::set_animation_path);
+    ClassDB::bind_method(D_METHOD("get_animation_path"), &LottieMultiAnimation::get_animation_path);
+    ClassDB::bind_method(D_METHOD("set_playing", "playing"), &LottieMultiAnimation::set_playing);
+    ClassDB::bind_method(D_METHOD("is_playing"), &LottieMultiAnimation::is_playing);
+    ClassDB::bind_method(D_METHOD("set_speed", "speed"), &LottieMultiAnimation::set_speed);
+    ClassDB::bind_method(D_METHOD("get_speed"), &LottieMultiAnimation::get_speed);
+    ClassDB::bind_method(D_METHOD("set_instance_count", "count"), &LottieMultiAnimation::set_instance_count);
+    ClassDB::bind_method(D_METHOD("get_instance_count"), &LottieMultiAnimation::get_instance_count);
+    ClassDB::bind_method(D_METHOD("set_instance_size", "size"), &LottieMultiAnimation::set_instance_size);
+    ClassDB::bind_method(D_METHOD("get_instance_size"), &LottieMultiAnimation::get_instance_size);
+    ClassDB::bind_method(D_METHOD("set_cell_size", "size"), &LottieMultiAnimation::set_cell_size);
+    ClassDB::bind_method(D_METHOD("get_cell_size"), &LottieMultiAnimation::get_cell_size);
+    ClassDB::bind_method(D_METHOD("set_atlas_frames", "frames"), &LottieMultiAnimation::set_atlas_frames);
+    ClassDB::bind_method(D_METHOD("get_atlas_frames"), &LottieMultiAnimation::get_atlas_frames);
+    ClassDB::bind_method(D_METHOD("set_instance_transform", "index", "transform"), &LottieMultiAnimation::set_instance_transform);
+    ClassDB::bind_method(D_METHOD("set_instance_phase", "index", "phase"), &LottieMultiAnimation::set_instance_phase);
+    ClassDB::bind_method(D_METHOD("set_instance_speed", "index", "speed"), &LottieMultiAnimation::set_instance_speed);
+    ClassDB::bind_method(D_METHOD("set_instance_positions", "positions"), &LottieMultiAnimation::set_instance_positions);
+    ClassDB::bind_method(D_METHOD("set_instance_phases", "phases"), &LottieMultiAnimation::set_instance_phases);
+
+    ADD_PROPERTY(PropertyInfo(Variant::STRING, "animation_path", PROPERTY_HINT_FILE, "*.json,*.lottie"), "set_animation_path", "get_animation_path");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "playing"), "set_playing", "is_playing");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "speed", PROPERTY_HINT_RANGE, "0.0,10.0,0.01"), "set_speed", "get_speed");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "instance_count", PROPERTY_HINT_RANGE, "0,100000,1"), "set_instance_count", "get_instance_count");
+    ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "instance_size"), "set_instance_size", "get_instance_size");
+    ADD_PROPERTY(PropertyInfo(Variant::VECTOR2I, "cell_size"), "set_cell_size", "get_cell_size");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "atlas_frames", PROPERTY_HINT_RANGE, "1,256,1"), "set_atlas_frames", "get_atlas_frames");
+}
+
+LottieMultiAnimation::LottieMultiAnimation() {
+}
+
+LottieMultiAnimation::~LottieMultiAnimation() {
+    if (draw_item.is_valid()) {
+        RenderingServer::get_singleton()->free_rid(draw_item);
+        draw_item = RID();
+    }
+    _release_animation();
+}
+
+void LottieMultiAnimation::release_shared_resources() {
+    g_multi_shader.unref();
+}
+
+void LottieMultiAnimation::_ready() {
+    if (!animation_path.is_empty()) _load();
+}
+
+void LottieMultiAnimation::_release_animation() {
+    if (canvas) { delete canvas; canvas = nullptr; }
+    if (animation) { delete animation; animation = nullptr; }
+    picture = nullptr;
+    total_frames = 0.0f;
+    duration = 0.0f;
+}
+
+bool LottieMultiAnimation::_load() {
+    _release_animation();
+    cell_count = 0;
+    if (animation_path.is_empty()) return false;
+
+    String source_path = LottieAnimation::resolve_source_path(animation_path);
+    if (source_path.is_empty()) return false;
+    LottieAnimation::ensure_thorvg_initialized();
+    canvas = tvg::SwCanvas::gen(tvg::EngineOption::SmartRender);
+    if (!canvas) {
+        UtilityFunctions::printerr("Failed to create ThorVG canvas");
+        return false;
+    }
+    animation = tvg::Animation::gen();
+    picture = animation->picture();
+    bool loaded = !LottieAnimation::load_picture(picture, source_path).is_empty();
+    if (!loaded || canvas->push(picture) != tvg::Result::Success) {
+        UtilityFunctions::printerr("Failed to load Lottie animation: " + animation_path);
+        _release_animation();
+        return false;
+    }
+    float pw = 0.0f, ph = 0.0f;
+    picture->size(&pw, &ph);
+    base_picture_size = Vector2i((int)std::ceil(std::max(1.0f, pw)), (int)std::ceil(std::max(1.0f, ph)));
+    total_frames = animation->totalFrame();
+    duration = animation->duration();
+    _layout_atlas();
+    return true;
+}
+
+void LottieMultiAnimation::_layout_atlas() {
+    if (!animation || total_frames <= 0) return;
+    const int max_columns = std::max(1, kMaxAtlasSide / cell_size.x);
+    const int max_rows = std::max(1, kMaxAtlasSide / cell_size.y);
+    cell_count = std::min(std::min(atlas_frames, (int)total_frames), max_columns * max_rows);
+    cell_count = std::max(1, cell_count);
+    atlas_columns = std::min(max_columns, (int)std::ceil(std::sqrt((double)cell_count)));
+    atlas_rows = (cell_count + atlas_columns - 1) / atlas_columns;
+    cell_ready.assign(cell_count, false);
+    cells_ready = 0;
+
+    const int atlas_w = atlas_columns * cell_size.x;
+    const int atlas_h = atlas_rows * cell_size.y;
+    atlas_pixels.resize((int64_t)atlas_w * atlas_h * 4);
+    atlas_pixels.fill(0);
+    atlas_image = Image::create_from_data(atlas_w, atlas_h, false, Image::FORMAT_RGBA8, atlas_pixels);
+    atlas_texture = ImageTexture::create_from_image(atlas_image);
+
+    cell_buffer.assign((size_t)cell_size.x * (size_t)cell_size.y, 0);
+    canvas->target(cell_buffer.data(), cell_size.x, cell_size.x, cell_size.y, tvg::ColorSpace::ARGB8888S);
+    LottieAnimation::fit_picture(picture, base_picture_size, cell_size);
+    draw_dirty = true;
+}
+
+void LottieMultiAnimation::_render_cell(int cell) {
+    const float frame = std::min(total_frames - 1.0f, std::floor((float)cell * total_frames / (float)cell_count));
+    animation->frame(frame);
+    canvas->update();
+    canvas->draw(false);
+    canvas->sync();
+    const int atlas_w = atlas_columns * cell_size.x;
+    const int col = cell % atlas_columns;
+    const int row = cell / atlas_columns;
+    uint8_t *dst = atlas_pixels.ptrw();
+    for (int y = 0; y < cell_size.y; y++) {
+        const size_t dst_offset = ((size_t)(row * cell_size.y + y) * atlas_w + (size_t)col * cell_size.x) * 4;
+        lottie_convert_argb_to_rgba(cell_buffer.data() + (size_t)y * cell_size.x, dst + dst_offset, (size_t)cell_size.x);
+    }
+    cell_ready[cell] = true;
+    cells_ready++;
+}
+
+void LottieMultiAnimation::_render_needed_cells() {
+    // Only the cells some instance shows this tick (plus the next one, so GPU rounding at a
+    // cell boundary never lands on an empty cell) are rasterized; after one loop none are left.
+    needed_cells.clear();
+    if (cell_count <= 0) return;
+    const float cycle = std::max(0.001f, duration);
+    const float *b = instance_buffer.ptr();
+    for (int i = 0; i < instance_count; i++) {
+        const float phase = b[i * kInstanceStride + 8];
+        const float inst_speed = b[i * kInstanceStride + 9];
+        double t = clock * inst_speed / cycle + phase;
+        t -= std::floor(t);
+        const int cell = std::min((int)(t * cell_count), cell_count - 1);
+        const int next = (cell + 1) % cell_count;
+        if (!cell_ready[cell]) needed_cells.push_back(cell);
+        if (!cell_ready[next]) needed_cells.push_back(next);
+    }
+    if (needed_cells.empty()) return;
+    for (int cell : needed_cells) {
+        if (!cell_ready[cell]) _render_cell(cell);
+    }
+    const int atlas_w = atlas_columns * cell_size.x;
+    const int atlas_h = atlas_rows * cell_size.y;
+    atlas_image->set_data(atlas_w, atlas_h, false, Image::FORMAT_RGBA8, atlas_pixels);
+    atlas_texture->update(atlas_image);
+}
+
+void LottieMultiAnimation::_rebuild_quad() {
+    PackedVector2Array vertices;
+    PackedVector2Array uvs;
+    PackedInt32Array indices;
+    const Vector2 h = instance_size * 0.5f;
+    vertices.push_back(Vector2(-h.x, -h.y));
+    vertices.push_back(Vector2(h.x, -h.y));
+    vertices.push_back(Vector2(h.x, h.y));
+    vertices.push_back(Vector2(-h.x, h.y));
+    uvs.push_back(Vector2(0, 0));
+    uvs.push_back(Vector2(1, 0));
+    uvs.push_back(Vector2(1, 1));
+    uvs.push_back(Vector2(0, 1));
+    const int32_t quad[6] = { 0, 1, 2, 0, 2, 3 };
+    for (int32_t idx : quad) indices.push_back(idx);
+    Array arrays;
+    arrays.resize(Mesh::ARRAY_MAX);
+    arrays[Mesh::ARRAY_VERTEX] = vertices;
+    arrays[Mesh::ARRAY_TEX_UV] = uvs;
+    arrays[Mesh::ARRAY_INDEX] = indices;
+    if (quad_mesh.is_null()) quad_mesh.instantiate();
+    quad_mesh->clear_surfaces();
+    quad_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+}
+
+void LottieMultiAnimation::_sync_draw() {
+    RenderingServer *rs = RenderingServer::get_singleton();
+    if (quad_mesh.is_null()) _rebuild_quad();
+    if (multimesh.is_null()) {
+        // Format and custom data must be set before the instance count allocates the buffer.
+        multimesh.instantiate();
+        multimesh->set_transform_format(MultiMesh::TRANSFORM_2D);
+        multimesh->set_use_custom_data(true);
+        multimesh->set_mesh(quad_mesh);
+        instance_buffer_dirty = true;
+    }
+    if (material.is_null()) {
+        if (g_multi_shader.is_null()) {
+            g_multi_shader.instantiate();
+            g_multi_shader->set_code(MULTI_SHADER_CODE);
+        }
+        material.instantiate();
+        material->set_shader(g_multi_shader);
+    }
+    if (!draw_item.is_valid()) {
+        // Child canvas item so the atlas material does not replace the node's own material.
+        draw_item = rs->canvas_item_create();
+        rs->canvas_item_set_parent(draw_item, get_canvas_item());
+        rs->canvas_item_set_material(draw_item, material->get_rid());
+    }
+    material->set_shader_parameter("duration", std::max(0.001f, duration));
+    material->set_shader_parameter("cell_count", cell_count);
+    material->set_shader_parameter("grid", Vector2((float)atlas_columns, (float)atlas_rows));
+    material->set_shader_parameter("cell_texels", Vector2((float)cell_size.x, (float)cell_size.y));
+    rs->canvas_item_clear(draw_item);
+    if (atlas_texture.is_valid()) {
+        rs->canvas_item_add_multimesh(draw_item, multimesh->get_rid(), atlas_texture->get_rid());
+    }
+    draw_dirty = false;
+}
+
+void LottieMultiAnimation::_process(double delta) {
+    if (!animation || cell_count <= 0 || !is_visible_in_tree()) return;
+    if (playing) clock += delta * speed;
+
+    if (cells_ready < cell_count && instance_count > 0) _render_needed_cells();
+    if (draw_dirty) _sync_draw();
+    if (instance_buffer_dirty) {
+        if (multimesh->get_instance_count() != instance_count) multimesh->set_instance_count(instance_count);
+        if (instance_count > 0) multimesh->set_buffer(instance_buffer);
+        instance_buffer_dirty = false;
+    }
+    // The only per-tick GPU update: one uniform drives every instance.
+    material->set_shader_parameter("clock", (float)clock);
+}
+
+void LottieMultiAnimation::set_animation_path(const String &p_path) {
+    if (animation_path == p_path) return;
+    animation_path = p_path;
+    clock = 0.0;
+    if (is_inside_tree()) _load();
+}
+
+String LottieMultiAnimation::get_animation_path() const { return animation_path; }
+void LottieMultiAnimation::set_playing(bool p_playing) { playing = p_playing; }
+bool LottieMultiAnimation::is_playing() const { return playing; }
+void LottieMultiAnimation::set_speed(float p_speed) { speed = p_speed; }
+float LottieMultiAnimation::get_speed() const { return speed; }
+
+void LottieMultiAnimation::set_instance_count(int p_count) {
+    p_count = std::max(0, p_count);
+    if (p_count == instance_count) return;
+    const int old_count = instance_count;
+    instance_count = p_count;
+    instance_buffer.resize((int64_t)p_count * kInstanceStride);
+    float *b = instance_buffer.ptrw();
+    for (int i = old_count; i < p_count; i++) {
+        float *inst = b + (size_t)i * kInstanceStride;
+        const float init[kInstanceStride] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0 };
+        memcpy(inst, init, sizeof(init));
+    }
+    instance_buffer_dirty = true;
+}
+
+int LottieMultiAnimation::get_instance_count() const { return instance_count; }
+
+void LottieMultiAnimation::set_instance_size(const Vector2 &p_size) {
+    instance_size = p_size;
+    if (quad_mesh.is_valid()) _rebuild_quad();
+}
+
+Vector2 LottieMultiAnimation::get_instance_size() const { return instance_size; }
+
+void LottieMultiAnimation::set_cell_size(const Vector2i &p_size) {
+    Vector2i size(std::max(8, std::min(p_size.x, kMaxAtlasSide)), std::max(8, std::min(p_size.y, kMaxAtlasSide)));
+    if (size == cell_size) return;
+    cell_size = size;
+    _layout_atlas();
+}
+
+Vector2i LottieMultiAnimation::get_cell_size() const { return cell_size; }
+
+void LottieMultiAnimation::set_atlas_frames(int p_frames) {
+    p_frames = std::max(1, p_frames);
+    if (p_frames == atlas_frames) return;
+    atlas_frames = p_frames;
+    _layout_atlas();
+}
+
+int LottieMultiAnimation::get_atlas_frames() const { return atlas_frames; }
+
+void LottieMultiAnimation::set_instance_transform(int p_index, const Transform2D &p_transform) {
+    if (p_index < 0 || p_index >= instance_count) return;
+    float *b = instance_buffer.ptrw() + (size_t)p_index * kInstanceStride;
+    b[0] = p_transform.columns[0].x;
+    b[1] = p_transform.columns[1].x;
+    b[2] = 0.0f;
+    b[3] = p_transform.columns[2].x;
+    b[4] = p_transform.columns[0].y;
+    b[5] = p_transform.columns[1].y;
+    b[6] = 0.0f;
+    b[7] = p_transform.columns[2].y;
+    instance_buffer_dirty = true;
+}
+
+void LottieMultiAnimation::set_instance_phase(int p_index, float p_phase) {
+    if (p_index < 0 || p_index >= instance_count) return;
+    instance_buffer.ptrw()[(size_t)p_index * kInstanceStride + 8] = p_phase;
+    instance_buffer_dirty = true;
+}
+
+void LottieMultiAnimation::set_instance_speed(int p_index, float p_speed) {
+    if (p_index < 0 || p_index >= instance_count) return;
+    instance_buffer.ptrw()[(size_t)p_index * kInstanceStride + 9] = p_speed;
+    instance_buffer_dirty = true;
+}
+
+void LottieMultiAnimation::set_instance_positions(const PackedVector2Array &p_positions) {
+    const int count = std::min(instance_count, (int)p_positions.size());
+    const Vector2 *src = p_positions.ptr();
+    float *b = instance_buffer.ptrw();
+    for (int i = 0; i < count; i++) {
+        b[(size_t)i * kInstanceStride + 3] = src[i].x;
+        b[(size_t)i * kInstanceStride + 7] = src[i].y;
+    }
+    instance_buffer_dirty = true;
+}
+
+void LottieMultiAnimation::set_instance_phases(const PackedFloat32Array &p_phases) {
+    const int count = std::min(instance_count, (int)p_phases.size());
+    const float *src = p_phases.ptr();
+    float *b = instance_buffer.ptrw();
+    for (int i = 0; i < count; i++) {
+        b[(size_t)i * kInstanceStride + 8] = src[i];
+    }
+    instance_buffer_dirty = true;
+}
@@ -0,0 +1,110 @@
+#ifndef LOTTIE_MULTI_ANIMATION_H
+#define LOTTIE_MULTI_ANIMATION_H
+
+#include <godot_cpp/classes/node2d.hpp>
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/image_texture.hpp>
+#include <godot_cpp/classes/array_mesh.hpp>
+#include <godot_cpp/classes/multi_mesh.hpp>
+#include <godot_cpp/classes/shader_material.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <vector>
+
+namespace tvg {
+    class SwCanvas;
+    class Animation;
+    class Picture;
+}
+
+namespace godot {
+
+// Draws many copies of one animation in a single MultiMesh draw call. Frames are rasterized
+// once into a shared atlas (one cell per frame bucket); each instance picks its cell on the
+// GPU from its phase and speed (custom data), so per-instance cost is a few floats.
+class LottieMultiAnimation : public Node2D {
+    GDCLASS(LottieMultiAnimation, Node2D)
+
+private:
+    String animation_path;
+    bool playing = true;
+    float speed = 1.0f;
+    int instance_count = 0;
+    Vector2 instance_size = Vector2(64, 64);
+    Vector2i cell_size = Vector2i(128, 128);
+    int atlas_frames = 24;
+
+    tvg::SwCanvas *canvas = nullptr;
+    tvg::Animation *animation = nullptr;
+    tvg::Picture *picture = nullptr;
+    std::vector<uint32_t> cell_buffer;
+    Vector2i base_picture_size;
+    float total_frames = 0.0f;
+    float duration = 0.0f;
+    double clock = 0.0;
+
+    // Atlas layout and which cells already hold their frame.
+    int cell_count = 0;
+    int atlas_columns = 1;
+    int atlas_rows = 1;
+    std::vector<bool> cell_ready;
+    int cells_ready = 0;
+    std::vector<int> needed_cells;
+    PackedByteArray atlas_pixels;
+    Ref<Image> atlas_image;
+    Ref<ImageTexture> atlas_texture;
+
+    // 12 floats per instance: 2D transform (8) + custom data (phase, speed, 0, 0).
+    PackedFloat32Array instance_buffer;
+    bool instance_buffer_dirty = true;
+    Ref<ArrayMesh> quad_mesh;
+    Ref<MultiMesh> multimesh;
+    Ref<ShaderMaterial> material;
+    RID draw_item;
+    bool draw_dirty = true;
+
+    bool _load();
+    void _release_animation();
+    void _layout_atlas();
+    void _render_cell(int cell);
+    void _render_needed_cells();
+    void _rebuild_quad();
+    void _sync_draw();
+
+protected:
+    static void _bind_methods();
+
+public:
+    LottieMultiAnimation();
+    ~LottieMultiAnimation();
+
+    void _ready() override;
+    void _process(double delta) override;
+
+    void set_animation_path(const String &p_path);
+    String get_animation_path() const;
+    void set_playing(bool p_playing);
+    bool is_playing() const;
+    void set_speed(float p_speed);
+    float get_speed() const;
+    void set_instance_count(int p_count);
+    int get_instance_count() const;
+    void set_instance_size(const Vector2 &p_size);
+    Vector2 get_instance_size() const;
+    void set_cell_size(const Vector2i &p_size);
+    Vector2i get_cell_size() const;
+    void set_atlas_frames(int p_frames);
+    int get_atlas_frames() const;
+
+    void set_instance_transform(int p_index, const Transform2D &p_transform);
+    void set_instance_phase(int p_index, float p_phase);
+    void set_instance_speed(int p_index, float p_speed);
+    void set_instance_positions(const PackedVector2Array &p_positions);
+    void set_instance_phases(const PackedFloat32Array &p_phases);
+
+    static void release_shared_resources();
+};
+
+}
+
+#endif
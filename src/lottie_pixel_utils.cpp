@@ -0,0 +1,151 @@
+#include "lottie_pixel_utils.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSSE3__)
+    #include <tmmintrin.h>
+    #define LOTTIE_SIMD_SSSE3 1
+#endif
+#if defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define LOTTIE_SIMD_NEON 1
+#endif
+
+namespace godot {
+
+void lottie_convert_argb_to_rgba(const uint32_t *src, uint8_t *dst, size_t count) {
+#if LOTTIE_SIMD_SSSE3
+    size_t vec_count = count / 4;
+    const __m128i mask = _mm_setr_epi8(
+        2, 1, 0, 3,
+        6, 5, 4, 7,
+        10, 9, 8, 11,
+        14, 13, 12, 15
+    );
+    const __m128i *srcv = reinterpret_cast<const __m128i*>(src);
+    __m128i *dstv = reinterpret_cast<__m128i*>(dst);
+    for (size_t i = 0; i < vec_count; ++i) {
+        __m128i pixels = _mm_loadu_si128(&srcv[i]);
+        __m128i shuffled = _mm_shuffle_epi8(pixels, mask);
+        _mm_storeu_si128(&dstv[i], shuffled);
+    }
+    size_t processed = vec_count * 4;
+    for (size_t i = processed; i < count; ++i) {
+        uint32_t p = src[i];
+        dst[i*4 + 0] = (uint8_t)((p >> 16) & 0xFF);
+        dst[i*4 + 1] = (uint8_t)((p >> 8) & 0xFF);
+        dst[i*4 + 2] = (uint8_t)(p & 0xFF);
+        dst[i*4 + 3] = (uint8_t)((p >> 24) & 0xFF);
+    }
+#elif LOTTIE_SIMD_NEON
+    size_t vec_count = count / 4;
+    static const uint8_t tbl_data[16] = {
+        2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15
+    };
+    uint8x16_t tbl = vld1q_u8(tbl_data);
+    for (size_t i = 0; i < vec_count; ++i) {
+        uint8x16_t pixels = vld1q_u8(reinterpret_cast<const uint8_t*>(&src[i*4]));
+#if defined(__aarch64__) || defined(__ARM_FEATURE_QBIT)
+        uint8x16_t shuffled = vqtbl1q_u8(pixels, tbl);
+#else
+        uint8_t tmp[16];
+        vst1q_u8(tmp, pixels);
+        uint8_t out[16];
+        for (int k=0;k<16;k++) out[k] = tmp[tbl_data[k]];
+        pixels = vld1q_u8(out);
+        uint8x16_t shuffled = pixels;
+#endif
+        vst1q_u8(&dst[i*16], shuffled);
+    }
+    size_t processed = vec_count * 4;
+    for (size_t i = processed; i < count; ++i) {
+        uint32_t p = src[i];
+        dst[i*4 + 0] = (uint8_t)((p >> 16) & 0xFF);
+        dst[i*4 + 1] = (uint8_t)((p >> 8) & 0xFF);
+        dst[i*4 + 2] = (uint8_t)(p & 0xFF);
+        dst[i*4 + 3] = (uint8_t)((p >> 24) & 0xFF);
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t p = src[i];
+        dst[i*4 + 0] = (uint8_t)((p >> 16) & 0xFF);
+        dst[i*4 + 1] = (uint8_t)((p >> 8) & 0xFF);
+        dst[i*4 + 2] = (uint8_t)(p & 0xFF);
+        dst[i*4 + 3] = (uint8_t)((p >> 24) & 0xFF);
+    }
+#endif
+}
+
+void lottie_convert_argb_to_rgba_rect(const uint32_t *src, uint8_t *dst, int width, int x0, int y0, int x1, int y1) {
+    if (x1 <= x0) return;
+    for (int y = y0; y < y1; ++y) {
+        const size_t offset = (size_t)y * (size_t)width + (size_t)x0;
+        lottie_convert_argb_to_rgba(src + offset, dst + offset * 4, (size_t)(x1 - x0));
+    }
+}
+
+uint64_t lottie_hash_pixels(const uint8_t *data, size_t bytes, uint64_t *r_check) {
+    // FNV-1a style over 64-bit words with a final avalanche; only needs to tell frames apart.
+    uint64_t h = 0xcbf29ce484222325ull ^ (uint64_t)bytes;
+    // The check hash rotates each word before a multiply-add, so a collision in one is unrelated
+    // to the other.
+    uint64_t c = 0x9e3779b97f4a7c15ull + (uint64_t)bytes;
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t w;
+        memcpy(&w, data + i, 8);
+        h = (h ^ w) * 0x100000001b3ull;
+        h ^= h >> 29;
+        c = (c + ((w << 31) | (w >> 33))) * 0xc2b2ae3d27d4eb4full;
+    }
+    for (; i < bytes; ++i) {
+        h = (h ^ data[i]) * 0x100000001b3ull;
+        c = (c + data[i]) * 0xc2b2ae3d27d4eb4full;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    if (r_check) {
+        c ^= c >> 29;
+        c *= 0xbf58476d1ce4e5b9ull;
+        c ^= c >> 32;
+        *r_check = c;
+    }
+    return h ? h : 1;
+}
+
+int LottieTileDiff::update(const uint32_t *argb, int width, int height) {
+    const size_t pixels = (size_t)width * (size_t)height;
+    if (!valid || width != w || height != h || previous.size() != pixels) {
+        w = width;
+        h = height;
+        tx = (width + TILE_SIZE - 1) / TILE_SIZE;
+        ty = (height + TILE_SIZE - 1) / TILE_SIZE;
+        previous.assign(argb, argb + pixels);
+        dirty.assign((size_t)tx * (size_t)ty, 1);
+        valid = true;
+        all = true;
+        return tx * ty;
+    }
+    std::fill(dirty.begin(), dirty.end(), 0);
+    int count = 0;
+    for (int y = 0; y < h; ++y) {
+        const uint32_t *cur = argb + (size_t)y * (size_t)w;
+        uint32_t *prev = previous.data() + (size_t)y * (size_t)w;
+        uint8_t *row_tiles = dirty.data() + (size_t)(y / TILE_SIZE) * (size_t)tx;
+        for (int t = 0; t < tx; ++t) {
+            const int x0 = t * TILE_SIZE;
+            const size_t n = (size_t)(std::min(w, x0 + TILE_SIZE) - x0);
+            if (memcmp(cur + x0, prev + x0, n * 4) == 0) continue;
+            memcpy(prev + x0, cur + x0, n * 4);
+            if (!row_tiles[t]) {
+                row_tiles[t] = 1;
+                count++;
+            }
+        }
+    }
+    all = count == tx * ty;
+    return count;
+}
+
+}
@@ -0,0 +1,47 @@
+#ifndef LOTTIE_PIXEL_UTILS_H
+#define LOTTIE_PIXEL_UTILS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace godot {
+
+// ThorVG ARGB8888 (premultiplied, native endian) -> Godot RGBA8 byte order. SIMD where available.
+void lottie_convert_argb_to_rgba(const uint32_t *src, uint8_t *dst, size_t count);
+// Same for the rectangle [x0, x1) x [y0, y1) of a `width`-pixel-wide image.
+void lottie_convert_argb_to_rgba_rect(const uint32_t *src, uint8_t *dst, int width, int x0, int y0, int x1, int y1);
+
+// Cheap 64-bit content hash of a pixel buffer (never returns 0, which means "no hash").
+// `r_check`, when given, receives a second, independently mixed hash from the same pass.
+uint64_t lottie_hash_pixels(const uint8_t *data, size_t bytes, uint64_t *r_check = nullptr);
+
+// Remembers the previous ARGB frame and reports which fixed-size tiles changed, so conversion,
+// post-processing and uploads can skip the parts of a frame that stayed the same.
+class LottieTileDiff {
+public:
+    static const int TILE_SIZE = 64;
+
+    // Compares `argb` with the previous frame and stores it. Returns the number of dirty tiles;
+    // after a size change or invalidate() every tile is dirty.
+    int update(const uint32_t *argb, int width, int height);
+    void invalidate() { valid = false; }
+    bool all_dirty() const { return all; }
+    int tiles_x() const { return tx; }
+    int tiles_y() const { return ty; }
+    bool is_dirty(int x, int y) const { return all || dirty[(size_t)y * (size_t)tx + (size_t)x] != 0; }
+
+private:
+    std::vector<uint32_t> previous;
+    std::vector<uint8_t> dirty;
+    int w = 0;
+    int h = 0;
+    int tx = 0;
+    int ty = 0;
+    bool valid = false;
+    bool all = true;
+};
+
+}
+
+#endif
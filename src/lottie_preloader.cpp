@@ -0,0 +1,197 @@
+#include "lottie_preloader.h"
+#include "lottie_animation.h"
+#include "lottie_pixel_utils.h"
+#include "lottie_resident_pool.h"
+#include <godot_cpp/classes/project_settings.hpp>
+#include <algorithm>
+#include <cmath>
+
+#include <thorvg.h>
+
+using namespace godot;
+
+static LottiePreloader *singleton = nullptr;
+
+LottiePreloader *LottiePreloader::get_singleton() {
+    if (!singleton) singleton = memnew(LottiePreloader);
+    return singleton;
+}
+
+void LottiePreloader::request(const String &source_path, const Vector2i &frame_size, bool worker_copy) {
+#ifdef __EMSCRIPTEN__
+    // No background threads on the nothreads web build; loads stay synchronous there.
+    return;
+#else
+    if (source_path.is_empty() || frame_size.x <= 0 || frame_size.y <= 0) return;
+    // A deferred-load node can preload before anything has created a canvas.
+    LottieAnimation::ensure_thorvg_initialized();
+    std::string key(source_path.utf8().get_data());
+    std::string abs8(ProjectSettings::get_singleton()->globalize_path(source_path).utf8().get_data());
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        if (_in_flight == key) return;
+        for (const Job &j : _queue) { if (j.key == key) return; }
+        for (const Ready &r : _ready) { if (r.key == key) return; }
+        Job job;
+        job.key = key;
+        job.abs_path8 = abs8;
+        job.frame_size = frame_size;
+        job.worker_copy = worker_copy;
+        _queue.push_back(job);
+    }
+    _start_if_needed();
+    _cv.notify_one();
+#endif
+}
+
+void LottiePreloader::request_resident(const std::string &abs_path8) {
+#ifndef __EMSCRIPTEN__
+    if (abs_path8.empty()) return;
+    LottieAnimation::ensure_thorvg_initialized();
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        Job job;
+        job.abs_path8 = abs_path8;
+        job.resident = true;
+        _queue.push_back(job);
+    }
+    _start_if_needed();
+    _cv.notify_one();
+#endif
+}
+
+bool LottiePreloader::take(const String &source_path, Prepared &out) {
+    std::string key(source_path.utf8().get_data());
+    std::lock_guard<std::mutex> lk(_mutex);
+    for (auto it = _ready.begin(); it != _ready.end(); ++it) {
+        if (it->key != key) continue;
+        out = std::move(it->prepared);
+        _ready.erase(it);
+        return true;
+    }
+    return false;
+}
+
+void LottiePreloader::set_max_ready(int count) {
+    std::lock_guard<std::mutex> lk(_mutex);
+    _max_ready = (size_t)std::max(1, count);
+    _trim_ready_locked();
+}
+
+void LottiePreloader::clear() {
+    std::lock_guard<std::mutex> lk(_mutex);
+    _queue.clear();
+    for (Ready &r : _ready) _release(r.prepared);
+    _ready.clear();
+}
+
+void LottiePreloader::shutdown() {
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _stop = true;
+    }
+    _cv.notify_all();
+    if (_thread.joinable()) _thread.join();
+    clear();
+    std::lock_guard<std::mutex> lk(_mutex);
+    _stop = false;
+}
+
+void LottiePreloader::_start_if_needed() {
+    std::lock_guard<std::mutex> lk(_mutex);
+    if (_thread.joinable() || _stop) return;
+    _thread = std::thread([this]() { _thread_loop(); });
+}
+
+void LottiePreloader::_trim_ready_locked() {
+    while (_ready.size() > _max_ready) {
+        _release(_ready.back().prepared);
+        _ready.pop_back();
+    }
+}
+
+void LottiePreloader::_release(Prepared &p) {
+    if (p.animation) {
+        delete p.animation;
+        p.animation = nullptr;
+    }
+    if (p.worker_animation) {
+        delete p.worker_animation;
+        p.worker_animation = nullptr;
+    }
+    p.first_frame_rgba.clear();
+}
+
+void LottiePreloader::_thread_loop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lk(_mutex);
+            _cv.wait(lk, [this]{ return _stop || !_queue.empty(); });
+            if (_stop) break;
+            job = _queue.front();
+            _queue.pop_front();
+            _in_flight = job.key;
+        }
+        if (job.resident) {
+            tvg::Animation *anim = _parse(job.abs_path8);
+            if (anim) LottieResidentPool::get_singleton()->give(job.abs_path8, anim, anim->totalFrame());
+            continue;
+        }
+        Ready ready;
+        ready.key = job.key;
+        bool ok = _prepare(job, ready.prepared);
+        std::lock_guard<std::mutex> lk(_mutex);
+        _in_flight.clear();
+        if (!ok) continue;
+        _ready.push_front(std::move(ready));
+        _trim_ready_locked();
+    }
+}
+
+tvg::Animation *LottiePreloader::_parse(const std::string &abs_path8) {
+    tvg::Animation *anim = tvg::Animation::gen();
+    tvg::Picture *pic = anim ? anim->picture() : nullptr;
+    if (!pic || pic->load(abs_path8.c_str()) != tvg::Result::Success) {
+        if (anim) delete anim;
+        return nullptr;
+    }
+    return anim;
+}
+
+bool LottiePreloader::_prepare(const Job &job, Prepared &out) {
+    tvg::Animation *anim = _parse(job.abs_path8);
+    if (!anim) return false;
+    tvg::Picture *pic = anim->picture();
+    float pw = 0.0f, ph = 0.0f;
+    pic->size(&pw, &ph);
+    if (pw <= 0 || ph <= 0) { pw = (float)job.frame_size.x; ph = (float)job.frame_size.y; }
+    out.animation = anim;
+    out.base_size = Vector2i((int)std::ceil(pw), (int)std::ceil(ph));
+    out.duration = anim->duration();
+    out.total_frames = anim->totalFrame();
+    out.frame_size = job.frame_size;
+    // A picture can only sit on one canvas, so the node's render thread needs an instance of its own.
+    if (job.worker_copy) out.worker_animation = _parse(job.abs_path8);
+
+    // Render frame 0 with the same fit transform the node uses, on a private canvas.
+    const int w = job.frame_size.x;
+    const int h = job.frame_size.y;
+    tvg::SwCanvas *canvas = tvg::SwCanvas::gen();
+    if (!canvas) return true; // parsed animation is still useful without a first frame
+    std::vector<uint32_t> argb((size_t)w * (size_t)h, 0u);
+    canvas->target(argb.data(), w, w, h, tvg::ColorSpace::ARGB8888S);
+    LottieAnimation::fit_picture(pic, out.base_size, job.frame_size);
+    if (canvas->push(pic) == tvg::Result::Success) {
+        anim->frame(0.0f);
+        canvas->update();
+        canvas->draw(false);
+        canvas->sync();
+        out.first_frame_rgba.resize((size_t)w * (size_t)h * 4);
+        lottie_convert_argb_to_rgba(argb.data(), out.first_frame_rgba.data(), (size_t)w * (size_t)h);
+        // Detach so the picture stays owned by the animation handed to the node.
+        canvas->remove(pic);
+    }
+    delete canvas;
+    return true;
+}
@@ -0,0 +1,77 @@
+#ifndef LOTTIE_PRELOADER_H
+#define LOTTIE_PRELOADER_H
+
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+#include <vector>
+#include <deque>
+#include <list>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace tvg {
+    class Animation;
+}
+
+namespace godot {
+
+// Parses Lottie JSON files on a background thread ahead of use and renders their first frame,
+// so a node switching to a predicted animation can adopt it without a synchronous load.
+class LottiePreloader {
+public:
+    struct Prepared {
+        tvg::Animation *animation = nullptr; // ownership passes to the caller of take()
+        tvg::Animation *worker_animation = nullptr; // second parsed copy for a render thread, if asked for
+        Vector2i base_size;
+        float duration = 0.0f;
+        float total_frames = 0.0f;
+        Vector2i frame_size;
+        std::vector<uint8_t> first_frame_rgba; // frame 0 fitted into frame_size, not post-processed
+    };
+
+    static LottiePreloader *get_singleton();
+
+    // worker_copy also parses a second instance, so a node's render thread can adopt one too.
+    void request(const String &source_path, const Vector2i &frame_size, bool worker_copy = false);
+    bool take(const String &source_path, Prepared &out);
+    // Parses the file and gives the animation to LottieResidentPool; nothing is rendered.
+    void request_resident(const std::string &abs_path8);
+    void set_max_ready(int count);
+    void clear();
+    void shutdown();
+
+private:
+    struct Job {
+        std::string key;
+        std::string abs_path8;
+        Vector2i frame_size;
+        bool worker_copy = false;
+        bool resident = false;
+    };
+    struct Ready {
+        std::string key;
+        Prepared prepared;
+    };
+
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<Job> _queue;
+    std::list<Ready> _ready; // most recent first
+    std::string _in_flight;
+    size_t _max_ready = 8;
+    bool _stop = false;
+
+    void _start_if_needed();
+    void _thread_loop();
+    static bool _prepare(const Job &job, Prepared &out);
+    static tvg::Animation *_parse(const std::string &abs_path8);
+    static void _release(Prepared &p);
+    void _trim_ready_locked();
+};
+
+}
+
+#endif
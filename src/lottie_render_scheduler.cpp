@@ -0,0 +1,69 @@
+#include "lottie_render_scheduler.h"
+#include "lottie_animation.h"
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <algorithm>
+#include <chrono>
+
+using namespace godot;
+
+static LottieRenderScheduler *singleton = nullptr;
+static const char *BUDGET_SETTING = "lottie/rendering/main_thread_budget_ms";
+
+LottieRenderScheduler *LottieRenderScheduler::get_singleton() {
+    if (!singleton) singleton = memnew(LottieRenderScheduler);
+    return singleton;
+}
+
+void LottieRenderScheduler::load_project_settings() {
+    ProjectSettings *settings = ProjectSettings::get_singleton();
+    if (!settings->has_setting(BUDGET_SETTING)) settings->set_setting(BUDGET_SETTING, 0.0);
+    settings->set_initial_value(BUDGET_SETTING, 0.0);
+    Dictionary info;
+    info["name"] = BUDGET_SETTING;
+    info["type"] = Variant::FLOAT;
+    info["hint"] = PROPERTY_HINT_RANGE;
+    info["hint_string"] = "0.0,33.0,0.1";
+    settings->add_property_info(info);
+    const double ms = (double)settings->get_setting(BUDGET_SETTING, 0.0);
+    set_budget_usec((int64_t)(std::max(0.0, ms) * 1000.0));
+}
+
+void LottieRenderScheduler::request(LottieAnimation *node) {
+    if (node->slice_queued) return;
+    if (!_connected && node->get_tree()) {
+        node->get_tree()->connect("process_frame", callable_mp_static(&LottieRenderScheduler::_on_process_frame));
+        _connected = true;
+    }
+    _queue.push_back(node);
+    node->slice_queued = true;
+}
+
+void LottieRenderScheduler::cancel(LottieAnimation *node) {
+    if (!node->slice_queued) return;
+    _queue.erase(std::remove(_queue.begin(), _queue.end(), node), _queue.end());
+    node->slice_queued = false;
+}
+
+void LottieRenderScheduler::set_budget_usec(int64_t usec) {
+    _budget_usec = std::max<int64_t>(0, usec);
+}
+
+void LottieRenderScheduler::_on_process_frame() {
+    if (singleton) singleton->_run();
+}
+
+void LottieRenderScheduler::_run() {
+    if (_queue.empty()) return;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(_budget_usec);
+    // Every step does some work, so the front node always progresses even over budget.
+    bool stepped = false;
+    while (!_queue.empty()) {
+        if (stepped && std::chrono::steady_clock::now() >= deadline) break;
+        LottieAnimation *node = _queue.front();
+        stepped = true;
+        if (node->_render_slice(deadline)) continue; // unfinished: keeps its place at the front
+        _queue.pop_front();
+        node->slice_queued = false;
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef LOTTIE_RENDER_SCHEDULER_H
+#define LOTTIE_RENDER_SCHEDULER_H
+
+#include <cstdint>
+#include <deque>
+
+namespace godot {
+
+class LottieAnimation;
+
+// Main-thread render queue for nodes running without the worker thread. Once per frame, before
+// nodes process, queued nodes are served oldest first until the time budget is spent; the rest
+// wait for the next frame. A large canvas converts its frame a few tile rows per step and keeps
+// its place at the front, so one big node cannot blow the frame time either.
+//
+// The budget is process-wide, from the project setting lottie/rendering/main_thread_budget_ms
+// (0 = nodes render synchronously in _process and the queue is unused).
+class LottieRenderScheduler {
+public:
+    static LottieRenderScheduler *get_singleton();
+    // Registers the project setting and applies its value; call once at module init.
+    void load_project_settings();
+
+    // Call from the main thread while the node is inside the tree; no-op when already queued.
+    void request(LottieAnimation *node);
+    void cancel(LottieAnimation *node);
+
+    void set_budget_usec(int64_t usec);
+    int64_t get_budget_usec() const { return _budget_usec; }
+
+private:
+    std::deque<LottieAnimation *> _queue;
+    int64_t _budget_usec = 0;
+    bool _connected = false;
+
+    static void _on_process_frame();
+    void _run();
+};
+
+}
+
+#endif
@@ -0,0 +1,115 @@
+#include "lottie_resident_pool.h"
+#include "lottie_preloader.h"
+#include <godot_cpp/core/memory.hpp>
+#include <algorithm>
+
+#include <thorvg.h>
+
+using namespace godot;
+
+static LottieResidentPool *singleton = nullptr;
+
+LottieResidentPool *LottieResidentPool::get_singleton() {
+    if (!singleton) singleton = memnew(LottieResidentPool);
+    return singleton;
+}
+
+void LottieResidentPool::open_bundle(const std::string &bundle8, const std::vector<Source> &sources, size_t budget_bytes, int copies) {
+    std::vector<std::string> to_parse;
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        Bundle &bundle = _bundles[bundle8];
+        const int had = bundle.users > 0 ? bundle.copies : 0;
+        bundle.users++;
+        bundle.budget = std::max(bundle.budget, budget_bytes);
+        bundle.copies = std::max(had, std::max(1, copies));
+        if (bundle.sources.empty()) bundle.sources = sources;
+        for (const Source &src : bundle.sources) {
+            _path_bundles[src.path8] = bundle8;
+            // Every animation is parsed once per wanted copy; later users only add missing copies.
+            for (int i = had; i < bundle.copies; i++) to_parse.push_back(src.path8);
+        }
+    }
+    for (const std::string &path8 : to_parse) LottiePreloader::get_singleton()->request_resident(path8);
+}
+
+void LottieResidentPool::close_bundle(const std::string &bundle8) {
+    std::vector<tvg::Animation *> dead;
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        auto it = _bundles.find(bundle8);
+        if (it == _bundles.end()) return;
+        if (--it->second.users > 0) return;
+        for (const Source &src : it->second.sources) _path_bundles.erase(src.path8);
+        _bundles.erase(it);
+        for (auto idle = _idle.begin(); idle != _idle.end();) {
+            if (idle->bundle8 != bundle8) { ++idle; continue; }
+            dead.push_back(idle->animation);
+            idle = _idle.erase(idle);
+        }
+    }
+    for (tvg::Animation *anim : dead) delete anim;
+}
+
+tvg::Animation *LottieResidentPool::take(const std::string &path8) {
+    std::lock_guard<std::mutex> lk(_mutex);
+    for (auto it = _idle.begin(); it != _idle.end(); ++it) {
+        if (it->path8 != path8) continue;
+        tvg::Animation *anim = it->animation;
+        auto bundle = _bundles.find(it->bundle8);
+        if (bundle != _bundles.end()) bundle->second.idle_bytes -= it->bytes;
+        _idle.erase(it);
+        return anim;
+    }
+    return nullptr;
+}
+
+void LottieResidentPool::give(const std::string &path8, tvg::Animation *anim, float total_frames) {
+    if (!anim) return;
+    anim->segment(0.0f, total_frames);
+    std::vector<tvg::Animation *> dead;
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        auto owner = _path_bundles.find(path8);
+        Bundle *bundle = owner != _path_bundles.end() ? &_bundles[owner->second] : nullptr;
+        int idle_copies = 0;
+        for (const Idle &idle : _idle) { if (idle.path8 == path8) idle_copies++; }
+        if (!bundle || idle_copies >= bundle->copies) {
+            dead.push_back(anim);
+        } else {
+            Idle idle;
+            idle.path8 = path8;
+            idle.bundle8 = owner->second;
+            for (const Source &src : bundle->sources) { if (src.path8 == path8) idle.bytes = src.bytes; }
+            idle.animation = anim;
+            bundle->idle_bytes += idle.bytes;
+            _idle.push_front(idle);
+            _trim_locked(owner->second, dead);
+        }
+    }
+    for (tvg::Animation *a : dead) delete a;
+}
+
+void LottieResidentPool::clear() {
+    std::vector<tvg::Animation *> dead;
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        for (Idle &idle : _idle) dead.push_back(idle.animation);
+        _idle.clear();
+        _bundles.clear();
+        _path_bundles.clear();
+    }
+    for (tvg::Animation *anim : dead) delete anim;
+}
+
+void LottieResidentPool::_trim_locked(const std::string &bundle8, std::vector<tvg::Animation *> &dead) {
+    Bundle &bundle = _bundles[bundle8];
+    auto it = _idle.end();
+    while (bundle.idle_bytes > bundle.budget && it != _idle.begin()) {
+        --it;
+        if (it->bundle8 != bundle8) continue;
+        bundle.idle_bytes -= it->bytes;
+        dead.push_back(it->animation);
+        it = _idle.erase(it);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef LOTTIE_RESIDENT_POOL_H
+#define LOTTIE_RESIDENT_POOL_H
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tvg {
+    class Animation;
+}
+
+namespace godot {
+
+// Parsed animations of open .lottie bundles, shared by every node and render thread using them.
+// Opening a bundle parses each of its animations in the background (on the preloader thread);
+// a node takes an instance when it switches to an animation and gives it back when it switches
+// away. Idle instances of a bundle are capped by one budget, least recently used dropped first.
+class LottieResidentPool {
+public:
+    struct Source {
+        std::string path8; // absolute path of the extracted JSON
+        size_t bytes = 0; // estimated parsed size
+    };
+
+    static LottieResidentPool *get_singleton();
+
+    // Main thread. `copies` instances of each animation are kept (2 when the node also renders on
+    // its own thread); several nodes opening one bundle share it with the largest budget asked for.
+    void open_bundle(const std::string &bundle8, const std::vector<Source> &sources, size_t budget_bytes, int copies);
+    void close_bundle(const std::string &bundle8);
+
+    // Any thread. take() returns null when no idle instance is pooled; give() takes ownership
+    // and frees the animation unless its bundle is open and has room for it. `total_frames` is
+    // the full timeline length: totalFrame() only reports the segment while one is applied, so
+    // give() resets the segment with it and take() hands out the whole timeline.
+    tvg::Animation *take(const std::string &path8);
+    void give(const std::string &path8, tvg::Animation *anim, float total_frames);
+
+    void clear();
+
+private:
+    struct Bundle {
+        int users = 0;
+        size_t budget = 0;
+        int copies = 1;
+        size_t idle_bytes = 0;
+        std::vector<Source> sources;
+    };
+    struct Idle {
+        std::string path8;
+        std::string bundle8;
+        size_t bytes = 0;
+        tvg::Animation *animation = nullptr;
+    };
+
+    std::mutex _mutex;
+    std::unordered_map<std::string, Bundle> _bundles;
+    std::unordered_map<std::string, std::string> _path_bundles; // animation path -> bundle
+    std::list<Idle> _idle; // most recently used first
+
+    // Unlinks entries over the bundle's budget; the caller deletes them outside the lock.
+    void _trim_locked(const std::string &bundle8, std::vector<tvg::Animation *> &dead);
+};
+
+}
+
+#endif
@@ -0,0 +1,72 @@
+#include "lottie_resolution_manager.h"
+#include "lottie_animation.h"
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <algorithm>
+#include <cmath>
+
+using namespace godot;
+
+static LottieResolutionManager *singleton = nullptr;
+
+LottieResolutionManager *LottieResolutionManager::get_singleton() {
+    if (!singleton) singleton = memnew(LottieResolutionManager);
+    return singleton;
+}
+
+float LottieResolutionManager::_max_axis_scale(const Transform2D &xform) {
+    return std::max(std::abs(xform.columns[0].length()), std::abs(xform.columns[1].length()));
+}
+
+void LottieResolutionManager::register_node(LottieAnimation *node) {
+    Viewport *viewport = node->get_viewport();
+    if (!viewport) return;
+    if (!_connected && node->get_tree()) {
+        // process_frame is emitted before any node's _process, so pushed sizes apply the same frame.
+        node->get_tree()->connect("process_frame", callable_mp_static(&LottieResolutionManager::_on_process_frame));
+        _connected = true;
+    }
+    const RID canvas = node->get_canvas();
+    Group *group = nullptr;
+    for (Group &g : _groups) {
+        if (g.viewport == viewport && g.canvas == canvas) {
+            group = &g;
+            break;
+        }
+    }
+    if (!group) {
+        _groups.emplace_back();
+        group = &_groups.back();
+        group->viewport = viewport;
+        group->canvas = canvas;
+        group->xform = viewport->get_final_transform() * node->get_canvas_transform();
+        group->scale = _max_axis_scale(group->xform);
+    }
+    group->nodes.insert(node);
+    node->_on_canvas_scale_changed(group->scale);
+}
+
+void LottieResolutionManager::unregister_node(LottieAnimation *node) {
+    for (auto it = _groups.begin(); it != _groups.end(); ++it) {
+        if (it->nodes.erase(node) == 0) continue;
+        if (it->nodes.empty()) _groups.erase(it);
+        return;
+    }
+}
+
+void LottieResolutionManager::_on_process_frame() {
+    if (singleton) singleton->_update();
+}
+
+void LottieResolutionManager::_update() {
+    for (Group &g : _groups) {
+        // Every node of the group shares this transform; one evaluation covers all of them.
+        const LottieAnimation *any = *g.nodes.begin();
+        const Transform2D xform = g.viewport->get_final_transform() * any->get_canvas_transform();
+        if (xform == g.xform) continue;
+        g.xform = xform;
+        const float scale = _max_axis_scale(xform);
+        if (scale == g.scale) continue; // panned, not zoomed
+        g.scale = scale;
+        for (LottieAnimation *node : g.nodes) node->_on_canvas_scale_changed(scale);
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef LOTTIE_RESOLUTION_MANAGER_H
+#define LOTTIE_RESOLUTION_MANAGER_H
+
+#include <godot_cpp/classes/viewport.hpp>
+#include <godot_cpp/variant/rid.hpp>
+#include <godot_cpp/variant/transform2d.hpp>
+#include <list>
+#include <unordered_set>
+
+namespace godot {
+
+class LottieAnimation;
+
+// Watches the canvas-to-screen transform (viewport final transform and camera / canvas layer)
+// once per frame, before nodes process, for each group of nodes sharing a viewport and canvas.
+// Only groups whose transform changed notify their nodes, which combine the new scale with their
+// own node-to-canvas scale and reallocate only when that crosses their resolution threshold.
+class LottieResolutionManager {
+public:
+    static LottieResolutionManager *get_singleton();
+
+    // Call from the main thread while the node is inside the tree.
+    void register_node(LottieAnimation *node);
+    void unregister_node(LottieAnimation *node);
+
+private:
+    struct Group {
+        Viewport *viewport = nullptr;
+        RID canvas;
+        Transform2D xform;
+        float scale = 1.0f;
+        std::unordered_set<LottieAnimation *> nodes;
+    };
+
+    std::list<Group> _groups;
+    bool _connected = false;
+
+    static void _on_process_frame();
+    static float _max_axis_scale(const Transform2D &xform);
+    void _update();
+};
+
+}
+
+#endif
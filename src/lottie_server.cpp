@@ -0,0 +1,238 @@
+#include "lottie_server.h"
+#include "lottie_animation.h"
+#include "lottie_pixel_utils.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/rendering_server.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <algorithm>
+#include <cmath>
+
+#include <thorvg.h>
+
+using namespace godot;
+
+LottieServer *LottieServer::singleton = nullptr;
+
+LottieServer *LottieServer::get_singleton() {
+    return singleton;
+}
+
+LottieServer::LottieServer() {
+    singleton = this;
+    RenderingServer::get_singleton()->connect("frame_pre_draw", callable_mp(this, &LottieServer::_on_frame_pre_draw));
+}
+
+LottieServer::~LottieServer() {
+    RenderingServer::get_singleton()->disconnect("frame_pre_draw", callable_mp(this, &LottieServer::_on_frame_pre_draw));
+    while (!instances.empty()) {
+        instance_free(instances.back()->self);
+    }
+    if (singleton == this) singleton = nullptr;
+}
+
+void LottieServer::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("instance_create"), &LottieServer::instance_create);
+    ClassDB::bind_method(D_METHOD("instance_free", "instance"), &LottieServer::instance_free);
+    ClassDB::bind_method(D_METHOD("instance_load", "instance", "path"), &LottieServer::instance_load);
+    ClassDB::bind_method(D_METHOD("instance_set_frame", "instance", "frame"), &LottieServer::instance_set_frame);
+    ClassDB::bind_method(D_METHOD("instance_get_frame", "instance"), &LottieServer::instance_get_frame);
+    ClassDB::bind_method(D_METHOD("instance_get_total_frames", "instance"), &LottieServer::instance_get_total_frames);
+    ClassDB::bind_method(D_METHOD("instance_get_duration", "instance"), &LottieServer::instance_get_duration);
+    ClassDB::bind_method(D_METHOD("instance_set_size", "instance", "size"), &LottieServer::instance_set_size);
+    ClassDB::bind_method(D_METHOD("instance_set_canvas_item", "instance", "canvas_item", "rect"), &LottieServer::instance_set_canvas_item);
+    ClassDB::bind_method(D_METHOD("instances_set_frames", "instances", "frames"), &LottieServer::instances_set_frames);
+    ClassDB::bind_method(D_METHOD("instances_set_sizes", "instances", "sizes"), &LottieServer::instances_set_sizes);
+    ClassDB::bind_method(D_METHOD("sync"), &LottieServer::sync);
+}
+
+RID LottieServer::instance_create() {
+    LottieAnimation::ensure_thorvg_initialized();
+    Instance *inst = memnew(Instance);
+    inst->canvas = tvg::SwCanvas::gen(tvg::EngineOption::SmartRender);
+    if (!inst->canvas) {
+        UtilityFunctions::printerr("Failed to create ThorVG canvas");
+        memdelete(inst);
+        return RID();
+    }
+    instances.push_back(inst);
+    inst->self = instance_owner.make_rid(inst);
+    return inst->self;
+}
+
+void LottieServer::instance_free(const RID &p_instance) {
+    Instance *inst = instance_owner.get_or_null(p_instance);
+    if (!inst) return;
+    if (inst->canvas_item.is_valid()) {
+        RenderingServer::get_singleton()->canvas_item_clear(inst->canvas_item);
+    }
+    delete inst->canvas;
+    delete inst->animation;
+    instances.erase(std::find(instances.begin(), instances.end(), inst));
+    instance_owner.free(p_instance);
+    memdelete(inst);
+}
+
+bool LottieServer::instance_load(const RID &p_instance, const String &p_path) {
+    Instance *inst = instance_owner.get_or_null(p_instance);
+    if (!inst) return false;
+    String source_path = LottieAnimation::resolve_source_path(p_path);
+    if (source_path.is_empty()) return false;
+
+    if (inst->picture) inst->canvas->remove();
+    delete inst->animation;
+    inst->animation = tvg::Animation::gen();
+    inst->picture = inst->animation->picture();
+
+    bool loaded = !LottieAnimation::load_picture(inst->picture, source_path).is_empty();
+    if (!loaded || inst->canvas->push(inst->picture) != tvg::Result::Success) {
+        UtilityFunctions::printerr("Failed to load Lottie animation: " + p_path);
+        delete inst->animation;
+        inst->animation = nullptr;
+        inst->picture = nullptr;
+        return false;
+    }
+
+    float pw = 0.0f, ph = 0.0f;
+    inst->picture->size(&pw, &ph);
+    inst->base_size = Vector2i((int)std::ceil(std::max(1.0f, pw)), (int)std::ceil(std::max(1.0f, ph)));
+    inst->total_frames = inst->animation->totalFrame();
+    inst->duration = inst->animation->duration();
+    inst->frame = 0.0f;
+    inst->rendered_qf = -1;
+    inst->size_dirty = true;
+    return true;
+}
+
+void LottieServer::instance_set_frame(const RID &p_instance, float p_frame) {
+    Instance *inst = instance_owner.get_or_null(p_instance);
+    if (!inst || inst->total_frames <= 0) return;
+    inst->frame = CLAMP(p_frame, 0.0f, inst->total_frames - 1);
+}
+
+float LottieServer::instance_get_frame(const RID &p_instance) const {
+    Instance *inst = instance_owner.get_or_null(p_instance);
+    return inst ? inst->frame : 0.0f;
+}
+
+float LottieServer::instance_get_total_frames(const RID &p_instance) const {
+    Instance *inst = instance_owner.get_or_null(p_instance);
+    return inst ? inst->total_frames : 0.0f;
+}
+
+float LottieServer::instance_get_duration(const RID &p_instance) const {
+    Instance *inst = instance_owner.get_or_null(p_instance);
+    return inst ? inst->duration : 0.0f;
+}
+
+void LottieServer::instance_set_size(const RID &p_instance, const Vector2i &p_size) {
+    Instance *inst = instance_owner.get_or_null(p_instance);
+    if (!inst || p_size.x <= 0 || p_size.y <= 0 || inst->size == p_size) return;
+    inst->size = p_size;
+    inst->size_dirty = true;
+}
+
+void LottieServer::instance_set_canvas_item(const RID &p_instance, const RID &p_canvas_item, const Rect2 &p_rect) {
+    Instance *inst = instance_owner.get_or_null(p_instance);
+    if (!inst) return;
+    if (inst->canvas_item.is_valid() && inst->canvas_item != p_canvas_item) {
+        RenderingServer::get_singleton()->canvas_item_clear(inst->canvas_item);
+    }
+    inst->canvas_item = p_canvas_item;
+    inst->rect = p_rect;
+    inst->drawn_texture = RID(); // re-issue the draw command
+    if (inst->rendered) _upload_instance(inst);
+}
+
+void LottieServer::instances_set_frames(const Array &p_instances, const PackedFloat32Array &p_frames) {
+    const int64_t count = std::min<int64_t>(p_instances.size(), p_frames.size());
+    const float *frames = p_frames.ptr();
+    for (int64_t i = 0; i < count; i++) {
+        instance_set_frame(p_instances[i], frames[i]);
+    }
+}
+
+void LottieServer::instances_set_sizes(const Array &p_instances, const PackedVector2Array &p_sizes) {
+    const int64_t count = std::min<int64_t>(p_instances.size(), p_sizes.size());
+    const Vector2 *sizes = p_sizes.ptr();
+    for (int64_t i = 0; i < count; i++) {
+        instance_set_size(p_instances[i], Vector2i((int)sizes[i].x, (int)sizes[i].y));
+    }
+}
+
+bool LottieServer::_fit_target(Instance *inst) {
+    if (!inst->size_dirty) return false;
+    inst->size_dirty = false;
+    inst->target_size = inst->size;
+    inst->buffer.assign((size_t)inst->size.x * (size_t)inst->size.y, 0);
+    inst->canvas->target(inst->buffer.data(), inst->size.x, inst->size.x, inst->size.y, tvg::ColorSpace::ARGB8888S);
+    LottieAnimation::fit_picture(inst->picture, inst->base_size, inst->size);
+    return true;
+}
+
+void LottieServer::_render_instance(uint32_t index) {
+    Instance *inst = render_batch[index];
+    inst->animation->frame(inst->frame);
+    inst->canvas->update();
+    inst->canvas->draw(false);
+    inst->canvas->sync();
+    const size_t pixels = (size_t)inst->target_size.x * (size_t)inst->target_size.y;
+    inst->rgba.resize(pixels * 4);
+    lottie_convert_argb_to_rgba(inst->buffer.data(), inst->rgba.data(), pixels);
+}
+
+void LottieServer::_upload_instance(Instance *inst) {
+    const Vector2i size = inst->target_size;
+    if (inst->rgba.size() != (size_t)size.x * (size_t)size.y * 4) return;
+    PackedByteArray bytes;
+    bytes.resize((int64_t)inst->rgba.size());
+    memcpy(bytes.ptrw(), inst->rgba.data(), inst->rgba.size());
+    if (inst->image.is_null()) {
+        inst->image = Image::create_from_data(size.x, size.y, false, Image::FORMAT_RGBA8, bytes);
+    } else {
+        inst->image->set_data(size.x, size.y, false, Image::FORMAT_RGBA8, bytes);
+    }
+    if (inst->texture.is_valid() && inst->texture->get_width() == size.x && inst->texture->get_height() == size.y) {
+        inst->texture->update(inst->image);
+    } else {
+        inst->texture = ImageTexture::create_from_image(inst->image);
+    }
+    if (!inst->canvas_item.is_valid()) return;
+    // The draw command references the texture RID; only re-issue it when the texture changed.
+    if (inst->drawn_texture != inst->texture->get_rid()) {
+        RenderingServer *rs = RenderingServer::get_singleton();
+        rs->canvas_item_clear(inst->canvas_item);
+        rs->canvas_item_add_texture_rect(inst->canvas_item, inst->rect, inst->texture->get_rid());
+        inst->drawn_texture = inst->texture->get_rid();
+    }
+}
+
+void LottieServer::sync() {
+    render_batch.clear();
+    for (Instance *inst : instances) {
+        if (!inst->animation) continue;
+        const bool resized = _fit_target(inst);
+        const int qf = (int)std::round(inst->frame);
+        if (!resized && qf == inst->rendered_qf) continue;
+        inst->rendered_qf = qf;
+        render_batch.push_back(inst);
+    }
+    if (render_batch.empty()) return;
+
+    if (render_batch.size() == 1) {
+        _render_instance(0);
+    } else {
+        WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+        int64_t group = pool->add_group_task(callable_mp(this, &LottieServer::_render_instance), (int32_t)render_batch.size(), -1, true, "LottieServer render");
+        pool->wait_for_group_task_completion(group);
+    }
+    for (Instance *inst : render_batch) {
+        _upload_instance(inst);
+        inst->rendered = true;
+    }
+    render_batch.clear();
+}
+
+void LottieServer::_on_frame_pre_draw() {
+    sync();
+}
@@ -0,0 +1,93 @@
+#ifndef LOTTIE_SERVER_H
+#define LOTTIE_SERVER_H
+
+#include <godot_cpp/classes/object.hpp>
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/image_texture.hpp>
+#include <godot_cpp/templates/rid_owner.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/rect2.hpp>
+#include <godot_cpp/variant/rid.hpp>
+#include <vector>
+
+namespace tvg {
+    class SwCanvas;
+    class Animation;
+    class Picture;
+}
+
+namespace godot {
+
+// Engine singleton holding RID-addressed Lottie instances. Instances have no node, process
+// callback or thread of their own: dirty ones are rasterized together on the WorkerThreadPool
+// right before drawing and uploaded into the canvas item they are attached to.
+// All methods must be called from the main thread.
+class LottieServer : public Object {
+    GDCLASS(LottieServer, Object)
+
+public:
+    struct Instance {
+        tvg::SwCanvas *canvas = nullptr;
+        tvg::Animation *animation = nullptr;
+        tvg::Picture *picture = nullptr;
+        std::vector<uint32_t> buffer;
+        std::vector<uint8_t> rgba;
+        Vector2i size = Vector2i(64, 64);
+        Vector2i base_size;
+        Vector2i target_size;
+        float frame = 0.0f;
+        float total_frames = 0.0f;
+        float duration = 0.0f;
+        int rendered_qf = -1;
+        bool size_dirty = true;
+        bool rendered = false;
+        Ref<Image> image;
+        Ref<ImageTexture> texture;
+        RID canvas_item;
+        Rect2 rect;
+        RID drawn_texture;
+        RID self;
+    };
+
+private:
+    static LottieServer *singleton;
+
+    RID_PtrOwner<Instance> instance_owner;
+    std::vector<Instance *> instances;
+    std::vector<Instance *> render_batch;
+
+    void _render_instance(uint32_t index);
+    void _upload_instance(Instance *inst);
+    bool _fit_target(Instance *inst);
+    void _on_frame_pre_draw();
+
+protected:
+    static void _bind_methods();
+
+public:
+    static LottieServer *get_singleton();
+
+    LottieServer();
+    ~LottieServer();
+
+    RID instance_create();
+    void instance_free(const RID &p_instance);
+    bool instance_load(const RID &p_instance, const String &p_path);
+    void instance_set_frame(const RID &p_instance, float p_frame);
+    float instance_get_frame(const RID &p_instance) const;
+    float instance_get_total_frames(const RID &p_instance) const;
+    float instance_get_duration(const RID &p_instance) const;
+    void instance_set_size(const RID &p_instance, const Vector2i &p_size);
+    void instance_set_canvas_item(const RID &p_instance, const RID &p_canvas_item, const Rect2 &p_rect);
+
+    // Batch setters: one call per frame for thousands of instances.
+    void instances_set_frames(const Array &p_instances, const PackedFloat32Array &p_frames);
+    void instances_set_sizes(const Array &p_instances, const PackedVector2Array &p_sizes);
+
+    // Renders and uploads every dirty instance now instead of waiting for the next draw.
+    void sync();
+};
+
+}
+
+#endif
@@ -2,6 +2,7 @@
 #include "lottie_animation.h"
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
+#include <algorithm>
 
 using namespace godot;
 
@@ -44,6 +45,7 @@ LottieAnimationState::~LottieAnimationState() {
 
 void LottieAnimationState::set_state_name(const String& name) {
     state_name = name;
+    emit_changed();
 }
 
 String LottieAnimationState::get_state_name() const {
@@ -52,6 +54,7 @@ String LottieAnimationState::get_state_name() const {
 
 void LottieAnimationState::set_animation_path(const String& path) {
     animation_path = path;
+    emit_changed();
 }
 
 String LottieAnimationState::get_animation_path() const {
@@ -60,6 +63,7 @@ String LottieAnimationState::get_animation_path() const {
 
 void LottieAnimationState::set_loop(bool p_loop) {
     loop = p_loop;
+    emit_changed();
 }
 
 bool LottieAnimationState::get_loop() const {
@@ -68,6 +72,7 @@ bool LottieAnimationState::get_loop() const {
 
 void LottieAnimationState::set_speed(float p_speed) {
     speed = MAX(0.0f, p_speed);
+    emit_changed();
 }
 
 float LottieAnimationState::get_speed() const {
@@ -76,6 +81,7 @@ float LottieAnimationState::get_speed() const {
 
 void LottieAnimationState::set_blend_time(float time) {
     blend_time = MAX(0.0f, time);
+    emit_changed();
 }
 
 float LottieAnimationState::get_blend_time() const {
@@ -122,6 +128,7 @@ LottieStateTransition::LottieStateTransition() {
     to_state = "";
     condition_parameter = "";
     condition_mode = "equals";
+    condition_mode_id = CONDITION_EQUALS;
     transition_time = 0.2f;
     auto_advance = false;
 }
@@ -131,6 +138,7 @@ LottieStateTransition::~LottieStateTransition() {
 
 void LottieStateTransition::set_from_state(const String& state) {
     from_state = state;
+    emit_changed();
 }
 
 String LottieStateTransition::get_from_state() const {
@@ -139,6 +147,7 @@ String LottieStateTransition::get_from_state() const {
 
 void LottieStateTransition::set_to_state(const String& state) {
     to_state = state;
+    emit_changed();
 }
 
 String LottieStateTransition::get_to_state() const {
@@ -147,6 +156,7 @@ String LottieStateTransition::get_to_state() const {
 
 void LottieStateTransition::set_condition_parameter(const String& param) {
     condition_parameter = param;
+    emit_changed();
 }
 
 String LottieStateTransition::get_condition_parameter() const {
@@ -155,6 +165,7 @@ String LottieStateTransition::get_condition_parameter() const {
 
 void LottieStateTransition::set_condition_value(const Variant& value) {
     condition_value = value;
+    emit_changed();
 }
 
 Variant LottieStateTransition::get_condition_value() const {
@@ -163,6 +174,12 @@ Variant LottieStateTransition::get_condition_value() const {
 
 void LottieStateTransition::set_condition_mode(const String& mode) {
     condition_mode = mode;
+    if (mode == "equals") condition_mode_id = CONDITION_EQUALS;
+    else if (mode == "not_equals") condition_mode_id = CONDITION_NOT_EQUALS;
+    else if (mode == "greater") condition_mode_id = CONDITION_GREATER;
+    else if (mode == "less") condition_mode_id = CONDITION_LESS;
+    else condition_mode_id = CONDITION_INVALID;
+    emit_changed();
 }
 
 String LottieStateTransition::get_condition_mode() const {
@@ -171,6 +188,7 @@ String LottieStateTransition::get_condition_mode() const {
 
 void LottieStateTransition::set_transition_time(float time) {
     transition_time = MAX(0.0f, time);
+    emit_changed();
 }
 
 float LottieStateTransition::get_transition_time() const {
@@ -179,12 +197,17 @@ float LottieStateTransition::get_transition_time() const {
 
 void LottieStateTransition::set_auto_advance(bool advance) {
     auto_advance = advance;
+    emit_changed();
 }
 
 bool LottieStateTransition::get_auto_advance() const {
     return auto_advance;
 }
 
+LottieStateTransition::ConditionMode LottieStateTransition::get_condition_mode_id() const {
+    return condition_mode_id;
+}
+
 bool LottieStateTransition::evaluate_condition(const Dictionary& parameters) const {
     if (auto_advance) {
         return true;
@@ -194,19 +217,22 @@ bool LottieStateTransition::evaluate_condition(const Dictionary& parameters) con
         return false;
     }
 
-    Variant param_value = parameters[condition_parameter];
-
-    if (condition_mode == "equals") {
-        return param_value == condition_value;
-    } else if (condition_mode == "not_equals") {
-        return param_value != condition_value;
-    } else if (condition_mode == "greater") {
-        return (float)param_value > (float)condition_value;
-    } else if (condition_mode == "less") {
-        return (float)param_value < (float)condition_value;
+    return compare_values(condition_mode_id, parameters[condition_parameter], condition_value);
+}
+
+bool LottieStateTransition::compare_values(ConditionMode mode, const Variant& param_value, const Variant& condition_value) {
+    switch (mode) {
+        case CONDITION_EQUALS:
+            return param_value == condition_value;
+        case CONDITION_NOT_EQUALS:
+            return param_value != condition_value;
+        case CONDITION_GREATER:
+            return (float)param_value > (float)condition_value;
+        case CONDITION_LESS:
+            return (float)param_value < (float)condition_value;
+        default:
+            return false;
     }
-
-    return false;
 }
 
 void LottieStateMachine::_bind_methods() {
@@ -232,6 +258,7 @@ void LottieStateMachine::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_all_parameters"), &LottieStateMachine::get_all_parameters);
     ClassDB::bind_method(D_METHOD("has_parameter", "param_name"), &LottieStateMachine::has_parameter);
 
+    ClassDB::bind_method(D_METHOD("compile"), &LottieStateMachine::compile);
     ClassDB::bind_method(D_METHOD("reset"), &LottieStateMachine::reset);
     ClassDB::bind_method(D_METHOD("is_in_blend"), &LottieStateMachine::is_in_blend);
     ClassDB::bind_method(D_METHOD("get_blend_progress"), &LottieStateMachine::get_blend_progress);
@@ -258,34 +285,192 @@ LottieStateMachine::LottieStateMachine() {
 LottieStateMachine::~LottieStateMachine() {
 }
 
-Ref<LottieAnimationState> LottieStateMachine::_find_state(const String& state_name) const {
+void LottieStateMachine::_mark_dirty() {
+    compiled_dirty = true;
+}
+
+void LottieStateMachine::compile() {
+    compiled_dirty = true;
+    _ensure_compiled();
+}
+
+void LottieStateMachine::_ensure_compiled() const {
+    if (!compiled_dirty) {
+        return;
+    }
+    compiled_dirty = false;
+    compiled_states.clear();
+    compiled_transitions.clear();
+    state_ids.clear();
+    param_slots.clear();
+    param_values.clear();
+    param_present.clear();
+    param_dependent_offsets.clear();
+    param_dependents.clear();
+    transition_dirty.clear();
+
+    compiled_states.reserve(states.size());
     for (int i = 0; i < states.size(); i++) {
         Ref<LottieAnimationState> state = states[i];
-        if (state.is_valid() && state->get_state_name() == state_name) {
-            return state;
+        if (!state.is_valid()) {
+            continue;
+        }
+        StringName key = state->get_state_name();
+        // First state with a given name wins, as with the former linear lookup.
+        if (state_ids.find(key) != state_ids.end()) {
+            continue;
         }
+        state_ids[key] = (int)compiled_states.size();
+        CompiledState cs;
+        cs.name = state->get_state_name();
+        cs.state = state;
+        compiled_states.push_back(cs);
     }
-    return Ref<LottieAnimationState>();
-}
 
-Array LottieStateMachine::_find_valid_transitions() const {
-    Array valid_transitions;
-    
-    for (int i = 0; i < transitions.size(); i++) {
+    // Bucket transitions by source state, keeping declaration order inside each bucket.
+    const int transition_total = transitions.size();
+    std::vector<int> from_ids(transition_total, -1);
+    std::vector<int> to_ids(transition_total, -1);
+    for (int i = 0; i < transition_total; i++) {
+        Ref<LottieStateTransition> transition = transitions[i];
+        if (!transition.is_valid()) {
+            continue;
+        }
+        auto from_it = state_ids.find(StringName(transition->get_from_state()));
+        auto to_it = state_ids.find(StringName(transition->get_to_state()));
+        if (from_it == state_ids.end() || to_it == state_ids.end()) {
+            continue;
+        }
+        from_ids[i] = from_it->second;
+        to_ids[i] = to_it->second;
+        compiled_states[from_it->second].transition_count++;
+    }
+    int offset = 0;
+    std::vector<int> cursor(compiled_states.size(), 0);
+    for (size_t s = 0; s < compiled_states.size(); s++) {
+        compiled_states[s].first_transition = offset;
+        cursor[s] = offset;
+        offset += compiled_states[s].transition_count;
+    }
+    compiled_transitions.resize(offset);
+    for (int i = 0; i < transition_total; i++) {
+        if (from_ids[i] < 0) {
+            continue;
+        }
         Ref<LottieStateTransition> transition = transitions[i];
-        if (transition.is_valid() && transition->get_from_state() == current_state) {
-            if (transition->evaluate_condition(parameters)) {
-                valid_transitions.push_back(transition);
+        CompiledTransition &ct = compiled_transitions[cursor[from_ids[i]]++];
+        ct.to_state = to_ids[i];
+        ct.value = transition->get_condition_value();
+        ct.mode = transition->get_condition_mode_id();
+        ct.auto_advance = transition->get_auto_advance();
+        if (ct.auto_advance) {
+            compiled_states[from_ids[i]].has_auto_advance = true;
+        }
+        const String param = transition->get_condition_parameter();
+        if (!ct.auto_advance && !param.is_empty()) {
+            StringName key = param;
+            auto slot_it = param_slots.find(key);
+            if (slot_it == param_slots.end()) {
+                ct.param_slot = (int)param_values.size();
+                param_slots[key] = ct.param_slot;
+                param_values.push_back(Variant());
+                param_present.push_back(0);
+            } else {
+                ct.param_slot = slot_it->second;
             }
         }
     }
-    
-    return valid_transitions;
+    // Index which transitions read each parameter slot so set_parameter() can dirty only those.
+    param_dependent_offsets.assign(param_values.size() + 1, 0);
+    for (const CompiledTransition &ct : compiled_transitions) {
+        if (ct.param_slot >= 0) {
+            param_dependent_offsets[ct.param_slot + 1]++;
+        }
+    }
+    for (size_t p = 1; p < param_dependent_offsets.size(); p++) {
+        param_dependent_offsets[p] += param_dependent_offsets[p - 1];
+    }
+    param_dependents.resize(param_dependent_offsets.back());
+    std::vector<int> dep_cursor(param_dependent_offsets.begin(), param_dependent_offsets.end() - 1);
+    for (int t = 0; t < (int)compiled_transitions.size(); t++) {
+        const int slot = compiled_transitions[t].param_slot;
+        if (slot >= 0) {
+            param_dependents[dep_cursor[slot]++] = t;
+        }
+    }
+    transition_dirty.assign(compiled_transitions.size(), 0);
+
+    // Seed parameter slots from values set before compilation.
+    for (const auto &slot : param_slots) {
+        String name = slot.first;
+        if (parameters.has(name)) {
+            param_values[slot.second] = parameters[name];
+            param_present[slot.second] = 1;
+        }
+    }
+
+    current_state_id = _find_state_id(current_state);
+    preloaded_state_id = -1;
+    _mark_state_transitions_dirty(current_state_id);
+}
+
+void LottieStateMachine::_mark_state_transitions_dirty(int state_id) const {
+    if (state_id < 0 || state_id >= (int)compiled_states.size()) {
+        return;
+    }
+    const CompiledState &cs = compiled_states[state_id];
+    if (cs.transition_count == 0) {
+        return;
+    }
+    std::fill(transition_dirty.begin() + cs.first_transition,
+              transition_dirty.begin() + cs.first_transition + cs.transition_count, (uint8_t)1);
+    evaluation_pending = true;
+}
+
+int LottieStateMachine::_find_state_id(const String& state_name) const {
+    _ensure_compiled();
+    auto it = state_ids.find(StringName(state_name));
+    return it == state_ids.end() ? -1 : it->second;
+}
+
+Ref<LottieAnimationState> LottieStateMachine::_find_state(const String& state_name) const {
+    int id = _find_state_id(state_name);
+    return id < 0 ? Ref<LottieAnimationState>() : compiled_states[id].state;
+}
+
+void LottieStateMachine::_preload_reachable_states(LottieAnimation* animation_node) const {
+    if (current_state_id < 0) {
+        return;
+    }
+    // Every state one transition away may be next; have their animations parsed before they are needed.
+    const CompiledState &from = compiled_states[current_state_id];
+    const int end = from.first_transition + from.transition_count;
+    for (int i = from.first_transition; i < end; i++) {
+        const CompiledState &to = compiled_states[compiled_transitions[i].to_state];
+        if (to.state.is_valid()) {
+            animation_node->preload_animation(to.state->get_animation_path());
+        }
+    }
+}
+
+bool LottieStateMachine::_evaluate_compiled(const CompiledTransition& transition) const {
+    if (transition.auto_advance) {
+        return true;
+    }
+    if (transition.param_slot < 0 || !param_present[transition.param_slot]) {
+        return false;
+    }
+    return LottieStateTransition::compare_values(transition.mode, param_values[transition.param_slot], transition.value);
 }
 
 void LottieStateMachine::add_state(const Ref<LottieAnimationState>& state) {
     if (state.is_valid()) {
         states.push_back(state);
+        Callable on_changed = callable_mp(this, &LottieStateMachine::_mark_dirty);
+        if (!state->is_connected("changed", on_changed)) {
+            state->connect("changed", on_changed);
+        }
+        _mark_dirty();
     }
 }
 
@@ -294,6 +479,13 @@ void LottieStateMachine::remove_state(const String& state_name) {
         Ref<LottieAnimationState> state = states[i];
         if (state.is_valid() && state->get_state_name() == state_name) {
             states.remove_at(i);
+            if (!states.has(state)) {
+                Callable on_changed = callable_mp(this, &LottieStateMachine::_mark_dirty);
+                if (state->is_connected("changed", on_changed)) {
+                    state->disconnect("changed", on_changed);
+                }
+            }
+            _mark_dirty();
             break;
         }
     }
@@ -314,6 +506,11 @@ int LottieStateMachine::get_state_count() const {
 void LottieStateMachine::add_transition(const Ref<LottieStateTransition>& transition) {
     if (transition.is_valid()) {
         transitions.push_back(transition);
+        Callable on_changed = callable_mp(this, &LottieStateMachine::_mark_dirty);
+        if (!transition->is_connected("changed", on_changed)) {
+            transition->connect("changed", on_changed);
+        }
+        _mark_dirty();
     }
 }
 
@@ -324,6 +521,13 @@ void LottieStateMachine::remove_transition(const String& from_state, const Strin
             transition->get_from_state() == from_state && 
             transition->get_to_state() == to_state) {
             transitions.remove_at(i);
+            if (!transitions.has(transition)) {
+                Callable on_changed = callable_mp(this, &LottieStateMachine::_mark_dirty);
+                if (transition->is_connected("changed", on_changed)) {
+                    transition->disconnect("changed", on_changed);
+                }
+            }
+            _mark_dirty();
             break;
         }
     }
@@ -342,14 +546,16 @@ void LottieStateMachine::set_current_state(const String& state_name) {
         return;
     }
 
-    Ref<LottieAnimationState> new_state = _find_state(state_name);
-    if (!new_state.is_valid()) {
+    int state_id = _find_state_id(state_name);
+    if (state_id < 0) {
         UtilityFunctions::printerr("State not found: " + state_name);
         return;
     }
 
     String old_state = current_state;
     current_state = state_name;
+    current_state_id = state_id;
+    _mark_state_transitions_dirty(state_id);
 
     emit_signal("state_changed", old_state, current_state);
 }
@@ -368,6 +574,32 @@ String LottieStateMachine::get_default_state() const {
 
 void LottieStateMachine::set_parameter(const String& param_name, const Variant& value) {
     parameters[param_name] = value;
+    if (compiled_dirty) {
+        return; // slots are seeded from `parameters` on the next compile
+    }
+    auto it = param_slots.find(StringName(param_name));
+    if (it == param_slots.end()) {
+        return; // no transition reads this parameter
+    }
+    const int slot = it->second;
+    if (param_present[slot] && param_values[slot] == value) {
+        return;
+    }
+    param_values[slot] = value;
+    param_present[slot] = 1;
+    if (current_state_id < 0) {
+        return;
+    }
+    // Only transitions leaving the current state matter; the rest are re-dirtied on state entry.
+    const CompiledState &cs = compiled_states[current_state_id];
+    const int bucket_end = cs.first_transition + cs.transition_count;
+    for (int d = param_dependent_offsets[slot]; d < param_dependent_offsets[slot + 1]; d++) {
+        const int t = param_dependents[d];
+        if (t >= cs.first_transition && t < bucket_end) {
+            transition_dirty[t] = 1;
+            evaluation_pending = true;
+        }
+    }
 }
 
 Variant LottieStateMachine::get_parameter(const String& param_name) const {
@@ -390,46 +622,82 @@ void LottieStateMachine::update(float delta, LottieAnimation* animation_node) {
         return;
     }
 
-    Array valid_transitions = _find_valid_transitions();
-    
-    if (valid_transitions.size() > 0) {
-        Ref<LottieStateTransition> transition = valid_transitions[0];
-        if (transition.is_valid()) {
-            String new_state = transition->get_to_state();
-            Ref<LottieAnimationState> state = _find_state(new_state);
-            
-            if (state.is_valid()) {
-                blend_from_state = current_state;
-                blend_to_state = new_state;
-                is_blending = true;
-                blend_progress = 0.0f;
-                
-                emit_signal("transition_started", current_state, new_state);
-                
+    _ensure_compiled();
+
+    if (current_state_id != preloaded_state_id) {
+        preloaded_state_id = current_state_id;
+        _preload_reachable_states(animation_node);
+    }
+
+    // Idle machines (no parameter change, no auto-advance, no blend) return without touching any transition.
+    const bool has_auto = current_state_id >= 0 && compiled_states[current_state_id].has_auto_advance;
+    if (!evaluation_pending && !has_auto && !is_blending) {
+        return;
+    }
+
+    if (current_state_id >= 0 && (evaluation_pending || has_auto)) {
+        evaluation_pending = false;
+        const CompiledState &from = compiled_states[current_state_id];
+        const int end = from.first_transition + from.transition_count;
+        for (int i = from.first_transition; i < end; i++) {
+            const CompiledTransition &transition = compiled_transitions[i];
+            // A clean transition was false when last evaluated and none of its inputs changed since.
+            if (!transition.auto_advance && !transition_dirty[i]) {
+                continue;
+            }
+            transition_dirty[i] = 0;
+            if (!_evaluate_compiled(transition)) {
+                continue;
+            }
+            // Copy out before emitting: a signal handler may edit the graph and trigger a recompile.
+            const int to_id = transition.to_state;
+            Ref<LottieAnimationState> state = compiled_states[to_id].state;
+            String new_state = compiled_states[to_id].name;
+
+            blend_from_state = current_state;
+            blend_to_state = new_state;
+            is_blending = true;
+            blend_progress = 0.0f;
+
+            emit_signal("transition_started", current_state, new_state);
+
+            if (state->get_blend_time() > 0.0f) {
+                // Outgoing animation keeps rendering and is blended on the GPU until the blend ends.
+                animation_node->crossfade_to(state->get_animation_path());
+            } else {
                 animation_node->set_animation_path(state->get_animation_path());
-                animation_node->set_looping(state->get_loop());
-                animation_node->set_speed(state->get_speed());
-                animation_node->play();
-                
-                current_state = new_state;
             }
+            animation_node->set_looping(state->get_loop());
+            animation_node->set_speed(state->get_speed());
+            animation_node->play();
+
+            current_state = new_state;
+            if (!compiled_dirty) {
+                current_state_id = to_id; // otherwise re-resolved by name on the next compile
+                _mark_state_transitions_dirty(to_id);
+            }
+            break;
         }
     }
 
     if (is_blending) {
-        Ref<LottieAnimationState> state = _find_state(current_state);
-        if (state.is_valid()) {
-            float blend_time = state->get_blend_time();
+        _ensure_compiled();
+        if (current_state_id >= 0) {
+            float blend_time = compiled_states[current_state_id].state->get_blend_time();
             if (blend_time > 0.0f) {
                 blend_progress += delta / blend_time;
                 if (blend_progress >= 1.0f) {
                     blend_progress = 1.0f;
                     is_blending = false;
+                    animation_node->finish_crossfade();
                     emit_signal("transition_finished", current_state);
+                } else {
+                    animation_node->set_crossfade_progress(get_blend_progress());
                 }
             } else {
                 is_blending = false;
                 blend_progress = 1.0f;
+                animation_node->finish_crossfade();
                 emit_signal("transition_finished", current_state);
             }
         }
@@ -441,6 +709,8 @@ void LottieStateMachine::reset() {
         set_current_state(default_state);
     }
     parameters.clear();
+    std::fill(param_present.begin(), param_present.end(), (uint8_t)0);
+    _mark_state_transitions_dirty(current_state_id);
     is_blending = false;
     blend_progress = 0.0f;
 }
@@ -5,6 +5,9 @@
 #include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/string_name.hpp>
+#include <vector>
+#include <unordered_map>
 
 namespace godot {
 
@@ -46,12 +49,22 @@ public:
 class LottieStateTransition : public Resource {
     GDCLASS(LottieStateTransition, Resource)
 
+public:
+    enum ConditionMode {
+        CONDITION_EQUALS,
+        CONDITION_NOT_EQUALS,
+        CONDITION_GREATER,
+        CONDITION_LESS,
+        CONDITION_INVALID,
+    };
+
 private:
     String from_state;
     String to_state;
     String condition_parameter;
     Variant condition_value;
     String condition_mode;
+    ConditionMode condition_mode_id;
     float transition_time;
     bool auto_advance;
 
@@ -83,7 +96,10 @@ public:
     void set_auto_advance(bool advance);
     bool get_auto_advance() const;
 
+    ConditionMode get_condition_mode_id() const;
+
     bool evaluate_condition(const Dictionary& parameters) const;
+    static bool compare_values(ConditionMode mode, const Variant& param_value, const Variant& condition_value);
 };
 
 class LottieStateMachine : public Resource {
@@ -101,8 +117,49 @@ private:
     String blend_to_state;
     bool is_blending;
 
+    struct StringNameHasher {
+        size_t operator()(const StringName &s) const { return (size_t)s.hash(); }
+    };
+
+    // Flat form of states/transitions rebuilt lazily whenever the graph or its resources change.
+    struct CompiledState {
+        String name;
+        Ref<LottieAnimationState> state;
+        int first_transition = 0;
+        int transition_count = 0;
+        bool has_auto_advance = false;
+    };
+    struct CompiledTransition {
+        int to_state = -1;
+        int param_slot = -1;
+        Variant value;
+        LottieStateTransition::ConditionMode mode = LottieStateTransition::CONDITION_INVALID;
+        bool auto_advance = false;
+    };
+
+    mutable bool compiled_dirty = true;
+    mutable std::vector<CompiledState> compiled_states;
+    mutable std::vector<CompiledTransition> compiled_transitions; // contiguous per source state
+    mutable std::unordered_map<StringName, int, StringNameHasher> state_ids;
+    mutable std::unordered_map<StringName, int, StringNameHasher> param_slots;
+    mutable std::vector<Variant> param_values;
+    mutable std::vector<uint8_t> param_present;
+    mutable int current_state_id = -1;
+
+    // Event-driven evaluation: parameter slot -> dependent transitions, plus per-transition dirty flags.
+    mutable std::vector<int> param_dependent_offsets; // size = slots + 1
+    mutable std::vector<int> param_dependents;
+    mutable std::vector<uint8_t> transition_dirty;
+    mutable bool evaluation_pending = false;
+    mutable int preloaded_state_id = -1;
+
+    void _ensure_compiled() const;
+    void _mark_dirty();
+    void _mark_state_transitions_dirty(int state_id) const;
+    int _find_state_id(const String& state_name) const;
     Ref<LottieAnimationState> _find_state(const String& state_name) const;
-    Array _find_valid_transitions() const;
+    bool _evaluate_compiled(const CompiledTransition& transition) const;
+    void _preload_reachable_states(LottieAnimation* animation_node) const;
 
 protected:
     static void _bind_methods();
@@ -137,6 +194,9 @@ public:
     Dictionary get_all_parameters() const;
     bool has_parameter(const String& param_name) const;
 
+    // Flattens states and transitions into indexed tables; done lazily by update() when needed.
+    void compile();
+
     // State machine update
     void update(float delta, LottieAnimation* animation_node);
     void reset();
@@ -1,10 +1,18 @@
 #include "register_types.h"
 #include "lottie_animation.h"
 #include "lottie_state_machine.h"
+#include "lottie_preloader.h"
+#include "lottie_disk_cache.h"
+#include "lottie_buffer_pool.h"
+#include "lottie_resident_pool.h"
+#include "lottie_server.h"
+#include "lottie_multi_animation.h"
+#include "lottie_render_scheduler.h"
 
 #include <gdextension_interface.h>
 #include <godot_cpp/core/defs.hpp>
 #include <godot_cpp/godot.hpp>
+#include <godot_cpp/classes/engine.hpp>
 
 using namespace godot;
 
@@ -17,12 +25,27 @@ void initialize_godot_lottie_module(ModuleInitializationLevel p_level) {
     GDREGISTER_CLASS(LottieAnimationState);
     GDREGISTER_CLASS(LottieStateTransition);
     GDREGISTER_CLASS(LottieStateMachine);
+    GDREGISTER_CLASS(LottieServer);
+    GDREGISTER_CLASS(LottieMultiAnimation);
+
+    LottieRenderScheduler::get_singleton()->load_project_settings();
+
+    memnew(LottieServer);
+    Engine::get_singleton()->register_singleton("LottieServer", LottieServer::get_singleton());
 }
 
 void uninitialize_godot_lottie_module(ModuleInitializationLevel p_level) {
     if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
         return;
     }
+    Engine::get_singleton()->unregister_singleton("LottieServer");
+    memdelete(LottieServer::get_singleton());
+    LottiePreloader::get_singleton()->shutdown();
+    LottieResidentPool::get_singleton()->clear();
+    LottieDiskCache::get_singleton()->shutdown();
+    LottieBufferPool::get_singleton()->clear();
+    LottieAnimation::release_shared_resources();
+    LottieMultiAnimation::release_shared_resources();
 }
 
 extern "C" {